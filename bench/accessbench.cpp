@@ -0,0 +1,61 @@
+#include "benchmark.h"
+#include "lib/aliasobservable.h"
+#include "lib/valueobservable.h"
+#include <string>
+
+namespace
+{
+    const int rounds = 1000000;
+
+    /*!
+     * \brief get() and set() latency through the Observable interface,
+     *        with a single subscriber.
+     */
+    template<typename T, typename Make>
+    void access(Observable<T>& observable, const std::string& name, Make make)
+    {
+        long sink = 0;
+        auto h = observable.addCallback([&sink](const T&) { ++sink; });
+
+        auto start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+            doNotOptimize(observable.get());
+
+        Benchmark::report("ns_per_get/" + name, Benchmark::secondsSince(start) * 1e9 / rounds);
+
+        start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+            observable.set(make(i));
+
+        Benchmark::report("ns_per_set/" + name, Benchmark::secondsSince(start) * 1e9 / rounds);
+
+        // Setting the current value again is filtered out by the comparison.
+        T same = observable.get();
+        start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+            observable.set(same);
+
+        Benchmark::report("ns_per_unchanged_set/" + name, Benchmark::secondsSince(start) * 1e9 / rounds);
+        doNotOptimize(sink);
+    }
+
+    Benchmark latency("observable.access", []()
+    {
+        {
+            ValueObservable<int> value(0);
+            access(value, "value_int", [](int i) { return i; });
+        }
+
+        {
+            ValueObservable<std::string> value("");
+            access(value, "value_string64", [](int i) { return std::string(64, char('a' + i % 26)); });
+        }
+
+        {
+            int backing = 0;
+            AliasObservable<int> alias([&backing]() { return backing; },
+                                       [&backing](int v) { backing = v; });
+            access(alias, "alias_int", [](int i) { return i; });
+        }
+    });
+}
@@ -0,0 +1,98 @@
+#include "benchmark.h"
+#include "lib/observablearena.h"
+#include "lib/valueobservable.h"
+#include "mainviewmodel.h"
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const int fieldCount = 300;
+    const int subscribersPerField = 2;
+    const int rounds = 200;
+
+    /*!< A screen with hundreds of fields, stored in the current arena, if any. */
+    struct LargeViewModel
+    {
+        using Field = ValueObservable<int>;
+        std::deque<Field, ArenaAllocator<Field>> fields;
+
+        LargeViewModel() : fields(ArenaAllocator<Field>(ObservableArena::current()))
+        {
+            for (int i = 0; i < fieldCount; ++i)
+                fields.emplace_back(i);
+        }
+    };
+
+    /*!< A view subscribing to every field. */
+    std::vector<Subscription> bindView(LargeViewModel& vm)
+    {
+        std::vector<Subscription> handles;
+        handles.reserve(fieldCount * subscribersPerField);
+        for (ValueObservable<int>& field : vm.fields)
+        {
+            for (int s = 0; s < subscribersPerField; ++s)
+                handles.push_back(field.addCallback([](const int& v) { doNotOptimize(v); }));
+        }
+
+        return handles;
+    }
+
+    template<typename Create>
+    void measure(const std::string& name, Create create)
+    {
+        std::size_t allocations = Benchmark::allocations();
+        auto start = Benchmark::Clock::now();
+        for (int r = 0; r < rounds; ++r)
+        {
+            std::shared_ptr<LargeViewModel> vm = create();
+            std::vector<Subscription> handles = bindView(*vm);
+            doNotOptimize(handles.size());
+        }
+
+        Benchmark::report("us_per_model/" + name, Benchmark::secondsSince(start) * 1e6 / rounds);
+        Benchmark::report("allocations_per_model/" + name,
+                          double(Benchmark::allocations() - allocations) / rounds);
+    }
+
+    Benchmark large("arena.large_model", []()
+    {
+        measure("heap", []() { return std::make_shared<LargeViewModel>(); });
+
+        measure("arena", []() {
+            ObservableArena::Ref arena = ObservableArena::create();
+            ObservableArena::Scope scope(arena.get());
+            return std::allocate_shared<LargeViewModel>(ArenaAllocator<LargeViewModel>(arena.get()));
+        });
+    });
+
+    Benchmark main("arena.main_view_model", []()
+    {
+        for (bool pooled : { false, true })
+        {
+            std::size_t allocations = Benchmark::allocations();
+            auto start = Benchmark::Clock::now();
+            for (int r = 0; r < rounds; ++r)
+            {
+                MainViewModelPtr vm = pooled ? MainViewModel::create() : std::make_shared<MainViewModel>();
+
+                // Roughly what MainView subscribes to.
+                std::vector<Subscription> handles;
+                for (int s = 0; s < 3; ++s)
+                {
+                    handles.push_back(vm->text().addCallback([](const std::string&) {}));
+                    handles.push_back(vm->caption().addCallback([](const std::string&) {}));
+                    handles.push_back(vm->more().addCallback([](const std::string&) {}));
+                    handles.push_back(vm->size().addCallback([](const Size&) {}));
+                }
+            }
+
+            const std::string name = pooled ? "create" : "make_shared";
+            Benchmark::report("us_per_model/" + name, Benchmark::secondsSince(start) * 1e6 / rounds);
+            Benchmark::report("allocations_per_model/" + name,
+                              double(Benchmark::allocations() - allocations) / rounds);
+        }
+    });
+}
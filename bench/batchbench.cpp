@@ -0,0 +1,59 @@
+#include "benchmark.h"
+#include "lib/valueobservable.h"
+#include <string>
+#include <vector>
+
+namespace
+{
+    const std::size_t fieldCount = 200;
+    const std::size_t subscribersPerField = 3;
+    const int updatesPerField = 5;
+    const int rounds = 100;
+
+    /*!
+     * \brief A bulk model load: every field of a large model is updated several times
+     *        (e.g. while a record streams in), and each field has a few "relayout" subscribers.
+     */
+    void load(bool batched)
+    {
+        using Field = ValueObservable<std::string>;
+        std::vector<std::unique_ptr<Field>> fields;
+        std::vector<Field::CallbackPtr> handles;
+        std::size_t notifications = 0;
+        std::size_t layoutWork = 0;
+        for (std::size_t f = 0; f < fieldCount; ++f)
+        {
+            fields.emplace_back(new Field(std::string(), false));
+            for (std::size_t s = 0; s < subscribersPerField; ++s)
+                handles.push_back(fields.back()->addCallback(
+                    [&](const std::string& v)
+                    {
+                        ++notifications;
+                        for (char c : v)
+                            layoutWork += c;
+                    }));
+        }
+
+        auto start = Benchmark::Clock::now();
+        for (int round = 0; round < rounds; ++round)
+        {
+            std::unique_ptr<ObservableBatch> batch(batched ? new ObservableBatch() : nullptr);
+            for (int u = 0; u < updatesPerField; ++u)
+                for (auto& field : fields)
+                    field->set(std::string(64, char('a' + (round * updatesPerField + u) % 26)));
+        }
+
+        double elapsed = Benchmark::secondsSince(start);
+        doNotOptimize(layoutWork);
+
+        std::string suffix = batched ? "/batched" : "/immediate";
+        Benchmark::report("notifications_per_load" + suffix, double(notifications) / rounds);
+        Benchmark::report("us_per_load" + suffix, elapsed * 1e6 / rounds);
+    }
+
+    Benchmark batch("observable.batch", []()
+    {
+        load(false);
+        load(true);
+    });
+}
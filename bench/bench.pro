@@ -0,0 +1,45 @@
+#-------------------------------------------------
+#
+# Microbenchmarks for the reusable lib/ templates
+#
+#-------------------------------------------------
+
+TEMPLATE = app
+TARGET = observable-bench
+
+CONFIG += console thread c++11
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += ..
+
+# "qmake CONFIG+=instrumented" measures the cost of lib/instrumentation.h.
+instrumented: DEFINES += OBSERVABLE_INSTRUMENTATION
+
+SOURCES += \
+        ../mainviewmodel.cpp \
+        accessbench.cpp \
+        arenabench.cpp \
+        batchbench.cpp \
+        benchmark.cpp \
+        bindingbench.cpp \
+        bindinggraphbench.cpp \
+        churnbench.cpp \
+        comparisonbench.cpp \
+        computedbench.cpp \
+        concurrentbench.cpp \
+        copybench.cpp \
+        devirtbench.cpp \
+        instrumentationbench.cpp \
+        main.cpp \
+        mapbench.cpp \
+        notifybench.cpp \
+        persistbench.cpp \
+        schedulerbench.cpp \
+        sharedbench.cpp \
+        snapshotbench.cpp \
+        subscribebench.cpp \
+        sweepbench.cpp \
+        vectorbench.cpp
+
+HEADERS += \
+        benchmark.h
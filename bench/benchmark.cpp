@@ -0,0 +1,138 @@
+#include "benchmark.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace
+{
+    Benchmark *registry = nullptr;
+    const char *current = "";
+    std::atomic<std::size_t> allocationCounter(0);
+    std::atomic<std::size_t> liveBytes(0);
+
+    // Every block is prefixed with its size, so that the live heap size can be tracked.
+    const std::size_t header = alignof(std::max_align_t);
+
+    struct Result
+    {
+        std::string benchmark;
+        std::string metric;
+        double value;
+    };
+
+    bool json = false;
+    std::vector<Result> results;
+
+    void printJson()
+    {
+        std::printf("{\"results\": [");
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            std::printf("%s\n  {\"benchmark\": \"%s\", \"metric\": \"%s\", \"value\": %.6g}",
+                        i ? "," : "", r.benchmark.c_str(), r.metric.c_str(), r.value);
+        }
+
+        std::printf("\n]}\n");
+    }
+}
+
+Benchmark::Benchmark(const char *name, Body body) :
+    _name(name), _body(body), _next(registry)
+{
+    registry = this;
+}
+
+void Benchmark::runAll(const std::string& filter)
+{
+    // The registry is a stack, so reverse it to run in the definition order.
+    Benchmark *ordered = nullptr;
+    while (registry)
+    {
+        Benchmark *next = registry->_next;
+        registry->_next = ordered;
+        ordered = registry;
+        registry = next;
+    }
+    registry = ordered;
+
+    for (Benchmark *b = registry; b; b = b->_next)
+    {
+        if (std::string(b->_name).find(filter) == std::string::npos)
+            continue;
+
+        current = b->_name;
+        b->_body();
+    }
+}
+
+int Benchmark::main(int argc, char *argv[])
+{
+    std::string filter;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+        if (arg == "--json")
+            json = true;
+        else
+            filter = arg;
+    }
+
+    runAll(filter);
+    if (json)
+        printJson();
+
+    return 0;
+}
+
+void Benchmark::report(const std::string& metric, double value)
+{
+    if (json)
+    {
+        results.push_back(Result { current, metric, value });
+        return;
+    }
+
+    std::printf("%-40s %-40s %14.3f\n", current, metric.c_str(), value);
+    std::fflush(stdout);
+}
+
+std::size_t Benchmark::allocations()
+{
+    return allocationCounter.load(std::memory_order_relaxed);
+}
+
+std::size_t Benchmark::allocatedBytes()
+{
+    return liveBytes.load(std::memory_order_relaxed);
+}
+
+void *operator new(std::size_t size)
+{
+    allocationCounter.fetch_add(1, std::memory_order_relaxed);
+    if (char *p = static_cast<char *>(std::malloc(size + header)))
+    {
+        *reinterpret_cast<std::size_t *>(p) = size;
+        liveBytes.fetch_add(size, std::memory_order_relaxed);
+        return p + header;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    if (!p)
+        return;
+
+    char *block = static_cast<char *>(p) - header;
+    liveBytes.fetch_sub(*reinterpret_cast<std::size_t *>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    operator delete(p);
+}
@@ -0,0 +1,66 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+/*!
+ * \brief A minimal benchmark registry.
+ *        Every benchmark is a static Benchmark instance
+ *        whose body is executed by runAll().
+ *        The measurements are printed as a table, or as JSON with --json:
+ *
+ *        {"results": [{"benchmark": "...", "metric": "...", "value": 1.0}, ...]}
+ *
+ *        so that the results of two releases may be compared by a script.
+ */
+class Benchmark
+{
+public:
+    using Body = std::function<void ()>;
+
+    Benchmark(const char *name, Body body);
+
+    /*!< Run every registered benchmark whose name contains the filter. */
+    static void runAll(const std::string& filter = std::string());
+
+    /*!
+     * \brief Entry point shared by the benchmark executables.
+     *        Usage: <executable> [--json] [filter]
+     */
+    static int main(int argc, char *argv[]);
+
+    /*!< Report a single measurement of the running benchmark. */
+    static void report(const std::string& metric, double value);
+
+    /*!< Number of heap allocations made by the process so far. */
+    static std::size_t allocations();
+
+    /*!< Number of bytes currently allocated on the heap with operator new. */
+    static std::size_t allocatedBytes();
+
+    using Clock = std::chrono::steady_clock;
+
+    /*!< Seconds elapsed since the given time point. */
+    static double secondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+private:
+    const char *_name;
+    Body _body;
+    Benchmark *_next;
+};
+
+/*!
+ * \brief Prevents the optimizer from discarding a computed value.
+ */
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif // BENCHMARK_H
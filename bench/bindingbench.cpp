@@ -0,0 +1,79 @@
+#include "benchmark.h"
+#include "lib/valueobservable.h"
+#include "mainviewmodel.h"
+#include <memory>
+#include <vector>
+
+namespace
+{
+    const std::size_t chainLength = 10;
+    const int rounds = 100000;
+
+    using Link = ValueObservable<int>;
+
+    std::vector<std::unique_ptr<Link>> makeChain()
+    {
+        std::vector<std::unique_ptr<Link>> chain;
+        for (std::size_t i = 0; i < chainLength; ++i)
+            chain.emplace_back(new Link(0));
+
+        return chain;
+    }
+
+    /*!< Propagation of a change through a chain of one-way bindings. */
+    void oneWay()
+    {
+        auto chain = makeChain();
+        for (std::size_t i = 1; i < chain.size(); ++i)
+            chain[i]->bind(*chain[i - 1], [](int v) { return v; });
+
+        auto start = Benchmark::Clock::now();
+        for (int i = 1; i <= rounds; ++i)
+            chain.front()->set(i);
+
+        Benchmark::report("ns_per_set/one_way_chain_10", Benchmark::secondsSince(start) * 1e9 / rounds);
+        doNotOptimize(chain.back()->get());
+    }
+
+    /*!< Propagation of a change through a chain of two-way bindings, from either end. */
+    void twoWay()
+    {
+        auto chain = makeChain();
+        for (std::size_t i = 1; i < chain.size(); ++i)
+            chain[i]->bindTwoWay(*chain[i - 1], [](int v) { return v; }, [](int v) { return v; });
+
+        auto start = Benchmark::Clock::now();
+        for (int i = 1; i <= rounds; ++i)
+            chain.front()->set(i);
+
+        Benchmark::report("ns_per_set/two_way_chain_10_forward", Benchmark::secondsSince(start) * 1e9 / rounds);
+
+        start = Benchmark::Clock::now();
+        for (int i = 1; i <= rounds; ++i)
+            chain.back()->set(-i);
+
+        Benchmark::report("ns_per_set/two_way_chain_10_backward", Benchmark::secondsSince(start) * 1e9 / rounds);
+        doNotOptimize(chain.front()->get());
+    }
+
+    Benchmark bindings("binding.chains", []()
+    {
+        oneWay();
+        twoWay();
+    });
+
+    Benchmark clone("viewmodel.clone", []()
+    {
+        MainViewModelPtr vm = std::make_shared<MainViewModel>();
+        vm->initialize();
+
+        const int count = 100000;
+        std::size_t before = Benchmark::allocations();
+        auto start = Benchmark::Clock::now();
+        for (int i = 0; i < count; ++i)
+            doNotOptimize(vm->clone());
+
+        Benchmark::report("ns_per_clone", Benchmark::secondsSince(start) * 1e9 / count);
+        Benchmark::report("allocs_per_clone", double(Benchmark::allocations() - before) / count);
+    });
+}
@@ -0,0 +1,95 @@
+#include "benchmark.h"
+#include "lib/syncgroup.h"
+#include "lib/valueobservable.h"
+#include <memory>
+#include <vector>
+
+namespace
+{
+    const int rounds = 100000;
+
+    using Node = ValueObservable<int>;
+    using Nodes = std::vector<std::unique_ptr<Node>>;
+
+    Nodes makeNodes(std::size_t count)
+    {
+        Nodes nodes;
+        for (std::size_t i = 0; i < count; ++i)
+            nodes.emplace_back(new Node(0));
+
+        return nodes;
+    }
+
+    /*!
+     * \brief Binds the nodes two-way along the given edges,
+     *        counting every convert/revert invocation.
+     */
+    void bindEdges(Nodes& nodes, const std::vector<std::pair<int, int>>& edges, std::size_t& conversions)
+    {
+        for (const auto& e : edges)
+            nodes[e.second]->bindTwoWay(*nodes[e.first],
+                                        [&conversions](int v) { ++conversions; return v; },
+                                        [&conversions](int v) { ++conversions; return v; });
+    }
+
+    void measure(const std::string& name, std::size_t count, const std::vector<std::pair<int, int>>& edges)
+    {
+        Nodes nodes = makeNodes(count);
+        std::size_t conversions = 0;
+        bindEdges(nodes, edges, conversions);
+
+        conversions = 0;
+        auto start = Benchmark::Clock::now();
+        for (int i = 1; i <= rounds; ++i)
+            nodes.front()->set(i);
+
+        double elapsed = Benchmark::secondsSince(start);
+        bool synchronized = true;
+        for (const auto& n : nodes)
+            synchronized = synchronized && (n->get() == rounds);
+
+        Benchmark::report("conversions_per_set/" + name, double(conversions) / rounds);
+        Benchmark::report("ns_per_set/" + name, elapsed * 1e9 / rounds);
+        Benchmark::report("out_of_sync/" + name, double(!synchronized));
+    }
+
+    void measureGroup(std::size_t count)
+    {
+        Nodes nodes = makeNodes(count);
+        SyncGroup<int> group;
+        for (auto& n : nodes)
+            group.add(*n);
+
+        auto start = Benchmark::Clock::now();
+        for (int i = 1; i <= rounds; ++i)
+            nodes.front()->set(i);
+
+        double elapsed = Benchmark::secondsSince(start);
+        bool synchronized = true;
+        for (const auto& n : nodes)
+            synchronized = synchronized && (n->get() == rounds);
+
+        const std::string name = "sync_group_" + std::to_string(count);
+        Benchmark::report("ns_per_set/" + name, elapsed * 1e9 / rounds);
+        Benchmark::report("out_of_sync/" + name, double(!synchronized));
+    }
+
+    Benchmark graph("binding.graph", []()
+    {
+        // A <-> B <-> C
+        measure("chain_3", 3, { {0, 1}, {1, 2} });
+
+        // A <-> B, B <-> C, C <-> A
+        measure("triangle", 3, { {0, 1}, {1, 2}, {2, 0} });
+
+        // Every pair of 6 nodes bound to each other.
+        std::vector<std::pair<int, int>> complete;
+        for (int i = 0; i < 6; ++i)
+            for (int j = i + 1; j < 6; ++j)
+                complete.push_back({ i, j });
+
+        measure("complete_6", 6, complete);
+
+        measureGroup(6);
+    });
+}
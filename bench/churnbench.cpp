@@ -0,0 +1,57 @@
+#include "benchmark.h"
+#include "lib/valueobservable.h"
+#include <random>
+#include <vector>
+
+namespace
+{
+    /*!
+     * \brief Subscribe/unsubscribe storm interleaved with set():
+     *        every round removes and re-adds a tenth of the subscribers
+     *        with removeCallback(), then changes the value.
+     */
+    void churn(std::size_t subscribers)
+    {
+        using Source = ValueObservable<int>;
+        Source source(0, false);
+        std::vector<Source::CallbackPtr> handles;
+        long sum = 0;
+        auto block = [&sum](int v) { sum += v; };
+        for (std::size_t i = 0; i < subscribers; ++i)
+            handles.push_back(source.addCallback(block));
+
+        std::mt19937 random(42);
+        std::uniform_int_distribution<std::size_t> pick(0, subscribers - 1);
+        const std::size_t perRound = subscribers / 10 + 1;
+        const int rounds = 200;
+
+        std::size_t before = Benchmark::allocations();
+        auto start = Benchmark::Clock::now();
+        for (int round = 1; round <= rounds; ++round)
+        {
+            for (std::size_t k = 0; k < perRound; ++k)
+            {
+                Source::CallbackPtr& h = handles[pick(random)];
+                source.removeCallback(h);
+                h = source.addCallback(block);
+            }
+
+            source.set(round);
+        }
+
+        double elapsed = Benchmark::secondsSince(start);
+        doNotOptimize(sum);
+
+        std::string suffix = "/" + std::to_string(subscribers);
+        Benchmark::report("ns_per_round" + suffix, elapsed * 1e9 / rounds);
+        Benchmark::report("ns_per_resubscribe" + suffix, elapsed * 1e9 / (rounds * perRound));
+        Benchmark::report("allocs_per_round" + suffix,
+                          double(Benchmark::allocations() - before) / rounds);
+    }
+
+    Benchmark storm("observable.churn", []()
+    {
+        for (std::size_t n : {100, 1000, 10000})
+            churn(n);
+    });
+}
@@ -0,0 +1,126 @@
+#include "benchmark.h"
+#include "lib/aliasobservable.h"
+#include "lib/valueobservable.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Values = std::vector<std::uint32_t>;
+
+    const std::size_t valueSize = 1 << 20;
+    const int rounds = 50;
+
+    /*!< FNV-1a over the elements. */
+    struct ValuesHash
+    {
+        std::size_t operator()(const Values& values) const
+        {
+            std::uint64_t h = 14695981039346656037ull;
+            for (std::uint32_t v : values)
+                h = (h ^ v) * 1099511628211ull;
+
+            return std::size_t(h);
+        }
+    };
+
+    enum class Policy { Equal, Hash, Always };
+
+    const char *policyName(Policy policy)
+    {
+        switch (policy)
+        {
+        case Policy::Equal: return "equal";
+        case Policy::Hash: return "hash";
+        case Policy::Always: return "always";
+        }
+
+        return "";
+    }
+
+    void apply(Observable<Values>& observable, Policy policy)
+    {
+        switch (policy)
+        {
+        case Policy::Equal: observable.compareByValue(); break;
+        case Policy::Hash: observable.compareByHash(ValuesHash()); break;
+        case Policy::Always: observable.compareAlways(); break;
+        }
+    }
+
+    /*!
+     * \brief Sets a value equal to the current one, which the policy has to detect (or not),
+     *        and one that differs in the last element only.
+     */
+    void measure(Observable<Values>& observable, Policy policy, const std::string& kind)
+    {
+        apply(observable, policy);
+
+        Values same(valueSize, 1);
+        Values changed(valueSize, 1);
+        observable.set(same);
+
+        auto start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+        {
+            changed.back() = (i % 2) ? 1 : 2;
+            observable.set(changed);
+        }
+
+        Benchmark::report(std::string("us_per_set/") + kind + "_" + policyName(policy),
+                          Benchmark::secondsSince(start) * 1e6 / rounds);
+    }
+
+    Benchmark policies("comparison.policies", []()
+    {
+        for (Policy policy : { Policy::Equal, Policy::Hash, Policy::Always })
+        {
+            ValueObservable<Values> value((Values()));
+            measure(value, policy, "value");
+
+            // The getter returns a copy, as widget getters do.
+            Values backing;
+            AliasObservable<Values> alias([&backing]() { return backing; },
+                                          [&backing](Values v) { backing = std::move(v); });
+            measure(alias, policy, "alias");
+        }
+    });
+
+    Benchmark versions("comparison.versions", []()
+    {
+        ValueObservable<Values> model(Values(valueSize, 1));
+
+        // A consumer redoing work only when the model has changed,
+        // once by comparing with a copy of the value it has seen, and once by the version.
+        Values seen = model.get();
+        std::size_t redone = 0;
+
+        auto start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+        {
+            const Values current = model.get();
+            if (current != seen)
+            {
+                seen = current;
+                ++redone;
+            }
+        }
+
+        Benchmark::report("us_per_check/deep_compare", Benchmark::secondsSince(start) * 1e6 / rounds);
+
+        std::uint64_t seenVersion = model.version();
+        start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+        {
+            if (model.version() != seenVersion)
+            {
+                seenVersion = model.version();
+                ++redone;
+            }
+        }
+
+        Benchmark::report("us_per_check/version", Benchmark::secondsSince(start) * 1e6 / rounds);
+        doNotOptimize(redone);
+    });
+}
@@ -0,0 +1,85 @@
+#include "benchmark.h"
+#include "lib/computedobservable.h"
+#include "lib/valueobservable.h"
+
+namespace
+{
+    const int rounds = 100000;
+
+    /*!
+     * \brief A diamond (A -> B, A -> C, B + C -> D) with a subscriber on D,
+     *        compared with the same graph made of eager one-way bindings.
+     */
+    void diamond()
+    {
+        std::size_t computations = 0;
+        long sum = 0;
+
+        {
+            ValueObservable<int> a(0);
+            ComputedObservable<int> b([&]() { ++computations; return a.get() * 2; }, a);
+            ComputedObservable<int> c([&]() { ++computations; return a.get() + 1; }, a);
+            ComputedObservable<int> d([&]() { ++computations; return b.get() + c.get(); }, b, c);
+            auto h = d.addCallback([&sum](int v) { sum += v; });
+
+            computations = 0;
+            auto start = Benchmark::Clock::now();
+            for (int i = 1; i <= rounds; ++i)
+                a.set(i);
+
+            Benchmark::report("ns_per_set/computed", Benchmark::secondsSince(start) * 1e9 / rounds);
+            Benchmark::report("computations_per_set/computed", double(computations) / rounds);
+            Benchmark::report("inconsistent/computed", double(d.get() != b.get() + c.get()));
+        }
+
+        {
+            // D is bound to B and to C separately, so it is updated twice per change,
+            // the first time with an inconsistent pair of inputs.
+            ValueObservable<int> a(0), b(0), c(0), d(0);
+            b.bind(a, [&](int v) { ++computations; return v * 2; });
+            c.bind(a, [&](int v) { ++computations; return v + 1; });
+            d.bind(b, [&](int) { ++computations; return b.get() + c.get(); });
+            d.bind(c, [&](int) { ++computations; return b.get() + c.get(); });
+            auto h = d.addCallback([&sum](int v) { sum += v; });
+
+            computations = 0;
+            auto start = Benchmark::Clock::now();
+            for (int i = 1; i <= rounds; ++i)
+                a.set(i);
+
+            Benchmark::report("ns_per_set/bindings", Benchmark::secondsSince(start) * 1e9 / rounds);
+            Benchmark::report("computations_per_set/bindings", double(computations) / rounds);
+
+            // The second update must settle D on the current inputs.
+            Benchmark::report("inconsistent/bindings", double(d.get() != b.get() + c.get()));
+        }
+
+        doNotOptimize(sum);
+    }
+
+    /*!
+     * \brief The same diamond without any subscriber: changes must not compute anything.
+     */
+    void unobserved()
+    {
+        std::size_t computations = 0;
+        ValueObservable<int> a(0);
+        ComputedObservable<int> b([&]() { ++computations; return a.get() * 2; }, a);
+        ComputedObservable<int> c([&]() { ++computations; return a.get() + 1; }, a);
+        ComputedObservable<int> d([&]() { ++computations; return b.get() + c.get(); }, b, c);
+
+        auto start = Benchmark::Clock::now();
+        for (int i = 1; i <= rounds; ++i)
+            a.set(i);
+
+        Benchmark::report("ns_per_set/unobserved", Benchmark::secondsSince(start) * 1e9 / rounds);
+        Benchmark::report("computations_per_set/unobserved", double(computations) / rounds);
+        doNotOptimize(d.get());
+    }
+
+    Benchmark computed("computed.diamond", []()
+    {
+        diamond();
+        unobserved();
+    });
+}
@@ -0,0 +1,132 @@
+#include "benchmark.h"
+#include "lib/concurrentobservable.h"
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Shared = ConcurrentObservable<std::string>;
+
+    unsigned maxThreads()
+    {
+        unsigned n = std::thread::hardware_concurrency();
+        return n ? n : 4;
+    }
+
+    /*!
+     * \brief Read throughput while one writer keeps changing the value,
+     *        for 1 to N reader threads.
+     */
+    void readScaling()
+    {
+        for (unsigned readers = 1; readers <= std::max(4u, maxThreads()); readers *= 2)
+        {
+            Shared shared(std::string(256, 'a'), false);
+            std::atomic<bool> running(true);
+            std::atomic<std::size_t> reads(0);
+
+            std::thread writer([&]()
+            {
+                std::size_t i = 0;
+                while (running.load(std::memory_order_relaxed))
+                    shared.set(std::string(256, char('a' + (++i % 26))));
+            });
+
+            std::vector<std::thread> threads;
+            auto start = Benchmark::Clock::now();
+            for (unsigned r = 0; r < readers; ++r)
+                threads.emplace_back([&]()
+                {
+                    std::size_t local = 0;
+                    std::size_t length = 0;
+                    while (running.load(std::memory_order_relaxed))
+                    {
+                        length += shared.snapshot()->size();
+                        ++local;
+                    }
+
+                    doNotOptimize(length);
+                    reads += local;
+                });
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            running = false;
+            for (std::thread& t : threads)
+                t.join();
+
+            writer.join();
+            Benchmark::report("reads_per_us/" + std::to_string(readers) + "_readers",
+                              double(reads) / (Benchmark::secondsSince(start) * 1e6));
+        }
+    }
+
+    /*!
+     * \brief Concurrent writers, readers and subscription churn.
+     *        A permanent subscriber must see every effective change exactly once,
+     *        and the final value must be the one it saw last.
+     */
+    void stress()
+    {
+        ConcurrentObservable<long> shared(0, false);
+        std::atomic<long> next(1);
+        std::atomic<bool> running(true);
+
+        long notified = 0;
+        long lastSeen = 0;
+        auto permanent = shared.addCallback([&](long v)
+        {
+            // Changes are serialized, so no synchronization is needed here.
+            ++notified;
+            lastSeen = v;
+        });
+
+        const unsigned writers = std::max(2u, maxThreads() / 2);
+        const long setsPerWriter = 20000;
+        std::vector<std::thread> threads;
+        for (unsigned w = 0; w < writers; ++w)
+            threads.emplace_back([&]()
+            {
+                for (long i = 0; i < setsPerWriter; ++i)
+                    shared.set(next++);
+            });
+
+        std::thread churn([&]()
+        {
+            std::atomic<std::size_t> count(0);
+            std::size_t rounds = 0;
+            while (running.load(std::memory_order_relaxed))
+            {
+                // Every other callback is removed explicitly, the rest die with their handles.
+                auto h = shared.addCallback([&count](long) { ++count; });
+                if (++rounds % 2)
+                    shared.removeCallback(h);
+            }
+        });
+
+        std::thread reader([&]()
+        {
+            long last = 0;
+            while (running.load(std::memory_order_relaxed))
+                last = shared.get();
+
+            doNotOptimize(last);
+        });
+
+        for (std::thread& t : threads)
+            t.join();
+
+        running = false;
+        churn.join();
+        reader.join();
+
+        Benchmark::report("sets", double(writers * setsPerWriter));
+        Benchmark::report("lost_notifications", double(writers * setsPerWriter - notified));
+        Benchmark::report("final_value_mismatch", double(shared.get() != lastSeen));
+    }
+
+    Benchmark concurrent("concurrent.read_scaling", readScaling);
+    Benchmark concurrentStress("concurrent.stress", stress);
+}
@@ -0,0 +1,113 @@
+#include "benchmark.h"
+#include "lib/valueobservable.h"
+#include "lib/aliasobservable.h"
+#include <string>
+#include <vector>
+
+namespace
+{
+    /*!
+     * \brief A payload that counts how many times it gets copied and moved.
+     */
+    struct CopyCounter
+    {
+        static std::size_t copies;
+        static std::size_t moves;
+
+        std::string payload;
+
+        explicit CopyCounter(std::string p = std::string()) : payload(std::move(p)) {}
+        CopyCounter(const CopyCounter& other) : payload(other.payload) { ++copies; }
+        CopyCounter(CopyCounter&& other) : payload(std::move(other.payload)) { ++moves; }
+
+        CopyCounter& operator=(const CopyCounter& other)
+        {
+            payload = other.payload;
+            ++copies;
+            return *this;
+        }
+
+        CopyCounter& operator=(CopyCounter&& other)
+        {
+            payload = std::move(other.payload);
+            ++moves;
+            return *this;
+        }
+
+        bool operator!=(const CopyCounter& other) const { return payload != other.payload; }
+
+        static void reset()
+        {
+            copies = 0;
+            moves = 0;
+        }
+    };
+
+    std::size_t CopyCounter::copies = 0;
+    std::size_t CopyCounter::moves = 0;
+
+    const std::size_t subscriberCount = 10;
+    const std::size_t payloadSize = 1 << 20;
+
+    template<typename O>
+    std::vector<typename O::CallbackPtr> subscribe(O& observable, std::size_t& seen)
+    {
+        std::vector<typename O::CallbackPtr> handles;
+        for (std::size_t i = 0; i < subscriberCount; ++i)
+            handles.push_back(observable.addCallback(
+                [&seen](const CopyCounter& v) { seen += v.payload.size(); }));
+
+        return handles;
+    }
+
+    void reportCopies(const std::string& scenario)
+    {
+        Benchmark::report("copies/" + scenario, double(CopyCounter::copies));
+        Benchmark::report("moves/" + scenario, double(CopyCounter::moves));
+    }
+
+    Benchmark copies("observable.copies", []()
+    {
+        std::size_t seen = 0;
+
+        {
+            ValueObservable<CopyCounter> value(CopyCounter(), false);
+            auto handles = subscribe(value, seen);
+
+            CopyCounter lvalue(std::string(payloadSize, 'a'));
+            CopyCounter::reset();
+            value.set(lvalue);
+            reportCopies("value_set_lvalue");
+
+            CopyCounter::reset();
+            value.set(CopyCounter(std::string(payloadSize, 'b')));
+            reportCopies("value_set_rvalue");
+        }
+
+        {
+            CopyCounter backing;
+            AliasObservable<CopyCounter> alias(
+                        [&backing]() { return backing; },
+                        [&backing](CopyCounter v) { backing = std::move(v); },
+                        false);
+            auto handles = subscribe(alias, seen);
+
+            CopyCounter::reset();
+            alias.set(CopyCounter(std::string(payloadSize, 'c')));
+            reportCopies("alias_set_rvalue");
+        }
+
+        {
+            ValueObservable<CopyCounter> source(CopyCounter(), false);
+            ValueObservable<CopyCounter> target(CopyCounter(), false);
+            auto handles = subscribe(target, seen);
+            target.bind(source, [](const CopyCounter& v) { return v; });
+
+            CopyCounter::reset();
+            source.set(CopyCounter(std::string(payloadSize, 'd')));
+            reportCopies("one_way_binding_rvalue");
+        }
+
+        doNotOptimize(seen);
+    });
+}
@@ -0,0 +1,83 @@
+#include "benchmark.h"
+#include "lib/valueobservable.h"
+#include <string>
+
+namespace
+{
+    const int rounds = 5000000;
+
+    /*!< A value observable left open to subclassing, as ValueObservable was before it became final. */
+    template<typename T>
+    class OpenValueObservable : public Observable<T>
+    {
+    public:
+        OpenValueObservable(T value) : _value(std::move(value)) {}
+
+        T get() { return _value; }
+
+    protected:
+        void doSet(T&& value) { _value = std::move(value); }
+        const T *stored() { return &_value; }
+
+    private:
+        T _value;
+    };
+
+    /*!< Hides the dynamic type from the optimizer, as a reference returned by a view model does. */
+    template<typename P>
+    P opaque(P p)
+    {
+        asm volatile("" : "+r"(p));
+        return p;
+    }
+
+    template<typename O>
+    void loop(O& observable, const std::string& name)
+    {
+        long sink = 0;
+        auto h = observable.addCallback([&sink](int v) { sink += v; });
+
+        auto start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+            doNotOptimize(observable.get());
+
+        Benchmark::report("ns_per_get/" + name, Benchmark::secondsSince(start) * 1e9 / rounds);
+
+        start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+            observable.set(i);
+
+        Benchmark::report("ns_per_set/" + name, Benchmark::secondsSince(start) * 1e9 / rounds);
+
+        // Dropped by the comparison, so no notification hides the call overhead.
+        start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+            observable.set(rounds - 1);
+
+        Benchmark::report("ns_per_unchanged_set/" + name, Benchmark::secondsSince(start) * 1e9 / rounds);
+        doNotOptimize(sink);
+    }
+
+    /*!
+     * \brief Tight get() and set() loops of an int observable
+     *        through its own type and through the Observable interface,
+     *        for the final ValueObservable and a non-final equivalent.
+     */
+    Benchmark devirtualized("observable.devirtualized", []()
+    {
+        {
+            ValueObservable<int> value(-1);
+            loop(*opaque(&value), "value_direct");
+        }
+
+        {
+            ValueObservable<int> value(-1);
+            loop(*opaque(static_cast<Observable<int> *>(&value)), "value_interface");
+        }
+
+        {
+            OpenValueObservable<int> value(-1);
+            loop(*opaque(static_cast<Observable<int> *>(&value)), "open_interface");
+        }
+    });
+}
@@ -0,0 +1,40 @@
+#include "benchmark.h"
+#include "lib/valueobservable.h"
+#include <sstream>
+#include <vector>
+
+namespace
+{
+    /*!
+     * \brief The notification hot path, to be compared between
+     *        a plain and an instrumented (CONFIG+=instrumented) build.
+     *        An instrumented build also reports the size of the JSON dump.
+     */
+    Benchmark instrumentation("observable.instrumentation", []()
+    {
+        ValueObservable<int> source(0, false);
+        source.setName("bench.source");
+
+        long sum = 0;
+        std::vector<ValueObservable<int>::CallbackPtr> handles;
+        for (int i = 0; i < 10; ++i)
+            handles.push_back(source.addCallback([&sum](int v) { sum += v; }));
+
+        const int rounds = 1000000;
+        auto start = Benchmark::Clock::now();
+        for (int i = 1; i <= rounds; ++i)
+        {
+            source.set(i);
+            source.set(i);
+        }
+
+        Benchmark::report("ns_per_set_pair/10_subscribers", Benchmark::secondsSince(start) * 1e9 / rounds);
+        doNotOptimize(sum);
+
+#ifdef OBSERVABLE_INSTRUMENTATION
+        std::ostringstream json;
+        Instrumentation::dumpJson(json);
+        Benchmark::report("dump_bytes", double(json.str().size()));
+#endif
+    });
+}
@@ -0,0 +1,132 @@
+#include "benchmark.h"
+#include "lib/observablemap.h"
+#include "lib/valueobservable.h"
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    const int keyCount = 10000;
+    const int updates = 200000;
+
+    /*!< The way keyed state is kept without ObservableMap: an observable per key and an index. */
+    using ObservableIndex = std::unordered_map<int, std::unique_ptr<ValueObservable<double>>>;
+
+    std::vector<int> randomKeys()
+    {
+        std::mt19937 rng(42);
+        std::vector<int> keys(updates);
+        for (int& k : keys)
+            k = int(rng() % keyCount);
+
+        return keys;
+    }
+
+    Benchmark memory("map.memory", []()
+    {
+        for (bool watched : { false, true })
+        {
+            const char *suffix = watched ? "_watched" : "";
+            std::vector<Subscription> handles;
+
+            std::size_t before = Benchmark::allocatedBytes();
+            {
+                ObservableMap<int, double> map;
+                for (int k = 0; k < keyCount; ++k)
+                {
+                    map.set(k, k);
+                    if (watched)
+                        handles.push_back(map.watch(k, [](const double *) {}));
+                }
+
+                Benchmark::report(std::string("bytes_per_entry/observable_map") + suffix,
+                                  double(Benchmark::allocatedBytes() - before) / keyCount);
+                handles.clear();
+            }
+
+            before = Benchmark::allocatedBytes();
+            {
+                ObservableIndex index;
+                for (int k = 0; k < keyCount; ++k)
+                {
+                    ValueObservable<double> *o = new ValueObservable<double>(k);
+                    index[k].reset(o);
+                    if (watched)
+                        handles.push_back(o->addCallback([](const double&) {}));
+                }
+
+                Benchmark::report(std::string("bytes_per_entry/value_observable_index") + suffix,
+                                  double(Benchmark::allocatedBytes() - before) / keyCount);
+                handles.clear();
+            }
+        }
+    });
+
+    Benchmark keyed("map.keyed_updates", []()
+    {
+        const std::vector<int> keys = randomKeys();
+        std::size_t woken = 0;
+        std::vector<Subscription> handles;
+
+        {
+            ObservableMap<int, double> map;
+            for (int k = 0; k < keyCount; ++k)
+            {
+                map.set(k, 0);
+                handles.push_back(map.watch(k, [&woken](const double *) { ++woken; }));
+            }
+
+            woken = 0;
+            auto start = Benchmark::Clock::now();
+            for (int i = 0; i < updates; ++i)
+                map.set(keys[i], i);
+
+            Benchmark::report("ns_per_update/observable_map", Benchmark::secondsSince(start) * 1e9 / updates);
+            Benchmark::report("woken_per_update/observable_map", double(woken) / updates);
+            handles.clear();
+        }
+
+        {
+            ObservableIndex index;
+            for (int k = 0; k < keyCount; ++k)
+            {
+                index[k].reset(new ValueObservable<double>(0));
+                handles.push_back(index[k]->addCallback([&woken](const double&) { ++woken; }));
+            }
+
+            woken = 0;
+            auto start = Benchmark::Clock::now();
+            for (int i = 0; i < updates; ++i)
+                index[keys[i]]->set(i);
+
+            Benchmark::report("ns_per_update/value_observable_index", Benchmark::secondsSince(start) * 1e9 / updates);
+            Benchmark::report("woken_per_update/value_observable_index", double(woken) / updates);
+            handles.clear();
+        }
+    });
+
+    Benchmark batched("map.batched_updates", []()
+    {
+        const std::vector<int> keys = randomKeys();
+        ObservableMap<int, double> map;
+        std::size_t notifications = 0;
+        std::size_t records = 0;
+        Subscription h = map.changes().addCallback([&](const ObservableMap<int, double>::Changes& changes) {
+            ++notifications;
+            records += changes.size();
+        });
+
+        auto start = Benchmark::Clock::now();
+        {
+            ObservableBatch batch;
+            for (int i = 0; i < updates; ++i)
+                map.set(keys[i], i);
+        }
+
+        Benchmark::report("ns_per_update", Benchmark::secondsSince(start) * 1e9 / updates);
+        Benchmark::report("notifications", double(notifications));
+        Benchmark::report("records", double(records));
+    });
+}
@@ -0,0 +1,68 @@
+#include "benchmark.h"
+#include "lib/valueobservable.h"
+#include <vector>
+
+namespace
+{
+    /*!
+     * \brief Measures heap allocations and time per set()
+     *        for a range of subscriber counts.
+     */
+    void notifyFanOut(std::size_t subscribers)
+    {
+        ValueObservable<int> source(0, false);
+        std::vector<ValueObservable<int>::CallbackPtr> handles;
+        long sum = 0;
+        for (std::size_t i = 0; i < subscribers; ++i)
+            handles.push_back(source.addCallback([&sum](int v) { sum += v; }));
+
+        const int rounds = subscribers > 1000 ? 100 : 10000;
+        std::size_t before = Benchmark::allocations();
+        auto start = Benchmark::Clock::now();
+        for (int i = 1; i <= rounds; ++i)
+            source.set(i);
+
+        double elapsed = Benchmark::secondsSince(start);
+        std::size_t allocated = Benchmark::allocations() - before;
+        doNotOptimize(sum);
+
+        std::string suffix = "/" + std::to_string(subscribers);
+        Benchmark::report("allocs_per_set" + suffix, double(allocated) / rounds);
+        Benchmark::report("ns_per_set" + suffix, elapsed * 1e9 / rounds);
+    }
+
+    /*!
+     * \brief Same as notifyFanOut, but half of the subscribers are dead,
+     *        so the first set() has to prune them.
+     */
+    void notifyWithDeadSubscribers(std::size_t subscribers)
+    {
+        ValueObservable<int> source(0, false);
+        std::vector<ValueObservable<int>::CallbackPtr> handles;
+        long sum = 0;
+        for (std::size_t i = 0; i < subscribers; ++i)
+            handles.push_back(source.addCallback([&sum](int v) { sum += v; }));
+
+        for (std::size_t i = 0; i < subscribers; i += 2)
+            handles[i] = nullptr;
+
+        source.set(1);
+
+        const int rounds = 100;
+        std::size_t before = Benchmark::allocations();
+        for (int i = 2; i <= rounds + 1; ++i)
+            source.set(i);
+
+        doNotOptimize(sum);
+        Benchmark::report("allocs_per_set_after_prune/" + std::to_string(subscribers),
+                          double(Benchmark::allocations() - before) / rounds);
+    }
+
+    Benchmark notify("observable.notify", []()
+    {
+        for (std::size_t n : {1, 10, 1000, 100000})
+            notifyFanOut(n);
+
+        notifyWithDeadSubscribers(1000);
+    });
+}
@@ -0,0 +1,93 @@
+#include "benchmark.h"
+#include "lib/observablefields.h"
+#include "lib/valueobservable.h"
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const int fieldCount = 10000;
+    const int rounds = 50;
+
+    /*!< A large model of short texts and numbers, each observed by a view. */
+    struct Model
+    {
+        std::deque<ValueObservable<std::string>> texts;
+        std::deque<ValueObservable<int>> numbers;
+        ObservableFields fields;
+        std::vector<Subscription> handles;
+
+        explicit Model(int seed)
+        {
+            for (int i = 0; i < fieldCount / 2; ++i)
+            {
+                texts.emplace_back(std::string(24, char('a' + (i + seed) % 26)));
+                numbers.emplace_back(i + seed);
+                fields.add(texts.back());
+                fields.add(numbers.back());
+                handles.push_back(texts.back().addCallback([](const std::string& s) { doNotOptimize(s.size()); }));
+                handles.push_back(numbers.back().addCallback([](int v) { doNotOptimize(v); }));
+            }
+        }
+    };
+
+    template<typename F>
+    void measure(const std::string& name, F f)
+    {
+        auto start = Benchmark::Clock::now();
+        for (int r = 0; r < rounds; ++r)
+            f(r);
+
+        Benchmark::report("us/" + name, Benchmark::secondsSince(start) * 1e6 / rounds);
+    }
+
+    /*!
+     * \brief Loading a saved model of 10000 fields, compared with setting the fields one by one.
+     *        Every round loads one of two different states, so that every field changes.
+     */
+    Benchmark persist("fields.persist", []()
+    {
+        Model saved0(0);
+        Model saved1(1);
+        std::vector<char> images[2] = { saved0.fields.save(), saved1.fields.save() };
+        Model* sources[2] = { &saved0, &saved1 };
+
+        Model model(0);
+
+        measure("set_each", [&](int r) {
+            const Model& source = *sources[(r + 1) % 2];
+            for (int i = 0; i < fieldCount / 2; ++i)
+            {
+                model.texts[i].set(source.texts[i].value());
+                model.numbers[i].set(source.numbers[i].value());
+            }
+        });
+
+        measure("set_each_batched", [&](int r) {
+            const Model& source = *sources[r % 2];
+            ObservableBatch batch;
+            for (int i = 0; i < fieldCount / 2; ++i)
+            {
+                model.texts[i].set(source.texts[i].value());
+                model.numbers[i].set(source.numbers[i].value());
+            }
+        });
+
+        measure("load_notify", [&](int r) {
+            const std::vector<char>& image = images[(r + 1) % 2];
+            model.fields.load(image.data(), image.size(), true);
+        });
+
+        measure("load_silent", [&](int r) {
+            const std::vector<char>& image = images[r % 2];
+            model.fields.load(image.data(), image.size(), false);
+        });
+
+        measure("save", [&](int) {
+            doNotOptimize(model.fields.save().size());
+        });
+
+        Benchmark::report("bytes/image", double(images[0].size()));
+    });
+}
@@ -0,0 +1,63 @@
+#include "benchmark.h"
+#include "lib/notificationscheduler.h"
+#include "lib/valueobservable.h"
+#include <memory>
+#include <vector>
+
+namespace
+{
+    const std::size_t chainLength = 1000;
+    const int rounds = 1000;
+
+    /*!< A chain of observables, each one's callback setting the next one, i.e. nested set() calls. */
+    struct Chain
+    {
+        std::vector<std::unique_ptr<ValueObservable<int>>> links;
+        std::vector<Subscription> handles;
+
+        Chain()
+        {
+            for (std::size_t i = 0; i < chainLength; ++i)
+                links.emplace_back(new ValueObservable<int>(0));
+
+            for (std::size_t i = 0; i + 1 < chainLength; ++i)
+            {
+                ValueObservable<int> *next = links[i + 1].get();
+                handles.push_back(links[i]->addCallback([next](int v) { next->set(v); }));
+            }
+        }
+    };
+
+    /*!
+     * \brief Propagation through a chain of 1000 nested updates,
+     *        recursing with synchronous notifications and flattened by a scheduler.
+     */
+    Benchmark scheduler("scheduler.chain", []()
+    {
+        {
+            Chain chain;
+            auto start = Benchmark::Clock::now();
+            for (int i = 1; i <= rounds; ++i)
+                chain.links.front()->set(i);
+
+            Benchmark::report("us_per_update/synchronous", Benchmark::secondsSince(start) * 1e6 / rounds);
+        }
+
+        {
+            Chain chain;
+            NotificationScheduler scheduler;
+            scheduler.install();
+
+            std::size_t allocations = Benchmark::allocations();
+            auto start = Benchmark::Clock::now();
+            for (int i = 1; i <= rounds; ++i)
+            {
+                chain.links.front()->set(i);
+                scheduler.run();
+            }
+
+            Benchmark::report("us_per_update/scheduled", Benchmark::secondsSince(start) * 1e6 / rounds);
+            Benchmark::report("allocs_per_update/scheduled", double(Benchmark::allocations() - allocations) / rounds);
+        }
+    });
+}
@@ -0,0 +1,91 @@
+#include "benchmark.h"
+#include "lib/sharedvalueobservable.h"
+#include "lib/valueobservable.h"
+#include <vector>
+
+namespace
+{
+    const int rounds = 20000;
+    const std::size_t items = 16 * 1024;
+
+    using Model = std::vector<double>;
+
+    Model makeModel(int seed)
+    {
+        return Model(items, double(seed));
+    }
+
+    /*!
+     * \brief Reading a large value, and keeping the value seen by a callback across later updates,
+     *        with the plain and the shared storage.
+     */
+    Benchmark shared("observable.shared", []()
+    {
+        {
+            ValueObservable<Model> value(makeModel(0));
+
+            auto start = Benchmark::Clock::now();
+            for (int i = 0; i < rounds; ++i)
+                doNotOptimize(value.get().size());
+
+            Benchmark::report("ns_per_read/value_get", Benchmark::secondsSince(start) * 1e9 / rounds);
+        }
+
+        {
+            SharedValueObservable<Model> value(makeModel(0));
+
+            auto start = Benchmark::Clock::now();
+            for (int i = 0; i < rounds; ++i)
+                doNotOptimize(value.snapshot()->size());
+
+            Benchmark::report("ns_per_read/shared_snapshot", Benchmark::secondsSince(start) * 1e9 / rounds);
+        }
+
+        // A subscriber keeping every value it has seen, e.g. for an undo history.
+        std::vector<Model> next;
+        for (int i = 0; i < 8; ++i)
+            next.push_back(makeModel(i + 1));
+
+        {
+            ValueObservable<Model> value(makeModel(0));
+            Model kept;
+            auto h = value.addCallback([&kept](const Model& m) { kept = m; });
+
+            auto start = Benchmark::Clock::now();
+            for (int i = 0; i < rounds; ++i)
+                value.set(next[i % next.size()]);
+
+            Benchmark::report("ns_per_set_kept/value", Benchmark::secondsSince(start) * 1e9 / rounds);
+        }
+
+        {
+            SharedValueObservable<Model> value(makeModel(0));
+            std::vector<SharedValueObservable<Model>::Snapshot> snapshots;
+            for (const Model& m : next)
+                snapshots.push_back(std::make_shared<const Model>(m));
+
+            SharedValueObservable<Model>::Snapshot kept;
+            auto h = value.addCallback([&kept, &value](const Model&) { kept = value.snapshot(); });
+
+            auto start = Benchmark::Clock::now();
+            for (int i = 0; i < rounds; ++i)
+                value.setSnapshot(snapshots[i % snapshots.size()]);
+
+            Benchmark::report("ns_per_set_kept/shared_snapshot", Benchmark::secondsSince(start) * 1e9 / rounds);
+        }
+
+        // Without anyone sharing the value the shared storage writes in place, like the plain one.
+        {
+            SharedValueObservable<Model> value(makeModel(0));
+            long sink = 0;
+            auto h = value.addCallback([&sink](const Model& m) { sink += long(m.size()); });
+
+            auto start = Benchmark::Clock::now();
+            for (int i = 0; i < rounds; ++i)
+                value.set(next[i % next.size()]);
+
+            Benchmark::report("ns_per_set/shared_exclusive", Benchmark::secondsSince(start) * 1e9 / rounds);
+            doNotOptimize(sink);
+        }
+    });
+}
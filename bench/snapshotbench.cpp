@@ -0,0 +1,87 @@
+#include "benchmark.h"
+#include "lib/observablefields.h"
+#include "lib/valueobservable.h"
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const int fieldCount = 200;
+    const std::size_t valueSize = 1024;
+    const int rounds = 200;
+
+    /*!< A model with many large text fields, each observed by a view. */
+    struct Model
+    {
+        std::deque<ValueObservable<std::string>> texts;
+        ObservableFields fields;
+        std::vector<Subscription> handles;
+
+        Model()
+        {
+            for (int i = 0; i < fieldCount; ++i)
+            {
+                texts.emplace_back(std::string(valueSize, char('a' + i % 26)));
+                fields.add(texts.back());
+                handles.push_back(texts.back().addCallback([](const std::string& s) { doNotOptimize(s.size()); }));
+            }
+        }
+    };
+
+    template<typename F>
+    void measure(const std::string& name, F f)
+    {
+        std::size_t allocations = Benchmark::allocations();
+        auto start = Benchmark::Clock::now();
+        for (int r = 0; r < rounds; ++r)
+            f(r);
+
+        Benchmark::report("us/" + name, Benchmark::secondsSince(start) * 1e6 / rounds);
+        Benchmark::report("allocations/" + name, double(Benchmark::allocations() - allocations) / rounds);
+    }
+
+    Benchmark clone("snapshot.clone", []()
+    {
+        Model source;
+        Model target;
+
+        measure("get_set", [&](int) {
+            ObservableBatch batch;
+            for (int i = 0; i < fieldCount; ++i)
+                target.texts[i].set(source.texts[i].get());
+
+            // Make the next round copy again.
+            source.texts[0].set(std::string(valueSize, char('A' + target.texts[0].version() % 26)));
+        });
+
+        measure("copy_to", [&](int) {
+            source.fields.copyTo(target.fields);
+            source.texts[0].set(std::string(valueSize, char('A' + target.texts[0].version() % 26)));
+        });
+    });
+
+    Benchmark undo("snapshot.undo", []()
+    {
+        Model model;
+        std::vector<ObservableSnapshot> history;
+        history.reserve(rounds + 1);
+
+        // An undo stack of full snapshots, one field edited between them.
+        measure("full_snapshot", [&](int r) {
+            model.texts[r % fieldCount].set(std::string(valueSize, char('A' + r % 26)));
+            history.push_back(model.fields.snapshot());
+        });
+
+        history.clear();
+        history.push_back(model.fields.snapshot());
+        measure("incremental_snapshot", [&](int r) {
+            model.texts[r % fieldCount].set(std::string(valueSize, char('a' + r % 26)));
+            history.push_back(model.fields.snapshot(history.back()));
+        });
+
+        measure("restore", [&](int r) {
+            model.fields.restore(history[r % history.size()]);
+        });
+    });
+}
@@ -0,0 +1,39 @@
+#include "benchmark.h"
+#include "lib/valueobservable.h"
+#include <memory>
+#include <vector>
+
+namespace
+{
+    /*!
+     * \brief Measures the cost of subscribing a small capturing lambda
+     *        and of releasing its handle.
+     */
+    Benchmark subscribe("observable.subscribe", []()
+    {
+        const std::size_t count = 100000;
+        ValueObservable<int> source(0, false);
+        std::vector<ValueObservable<int>::CallbackPtr> handles;
+        handles.reserve(count);
+
+        long sum = 0;
+        std::shared_ptr<int> capture = std::make_shared<int>(1);
+
+        std::size_t before = Benchmark::allocations();
+        auto start = Benchmark::Clock::now();
+        for (std::size_t i = 0; i < count; ++i)
+            handles.push_back(source.addCallback(
+                [&sum, capture](int v) { sum += v * *capture; }));
+
+        double elapsed = Benchmark::secondsSince(start);
+        std::size_t allocated = Benchmark::allocations() - before;
+        Benchmark::report("allocs_per_subscribe", double(allocated) / count);
+        Benchmark::report("ns_per_subscribe", elapsed * 1e9 / count);
+
+        start = Benchmark::Clock::now();
+        handles.clear();
+        Benchmark::report("ns_per_release", Benchmark::secondsSince(start) * 1e9 / count);
+
+        doNotOptimize(sum);
+    });
+}
@@ -0,0 +1,50 @@
+#include "benchmark.h"
+#include "lib/valueobservable.h"
+#include <string>
+#include <vector>
+
+namespace
+{
+    const int cycles = 100000;
+
+    /*!
+     * \brief A long-lived observable that never changes, like a caption,
+     *        while short-lived views subscribe to it and drop their handles.
+     *        A few of the views stay open, and every view binds a model field of its own.
+     */
+    Benchmark sweep("observable.sweep", []()
+    {
+        ValueObservable<std::string> caption("caption");
+        ValueObservable<std::string> title("");
+        std::vector<Subscription> open;
+
+        auto start = Benchmark::Clock::now();
+        for (int i = 0; i < cycles; ++i)
+        {
+            Subscription view = caption.addCallback([](const std::string& s) { doNotOptimize(s.size()); });
+            if (i % 1000 == 0)
+                open.push_back(view);
+
+            ValueObservable<std::string> field("");
+            title.bind(field, [](const std::string& s) { return s; });
+        }
+
+        Benchmark::report("ns_per_view", Benchmark::secondsSince(start) * 1e9 / cycles);
+
+        ObservableMemory m = caption.memory();
+        Benchmark::report("callbacks/live", double(m.callbacks));
+        Benchmark::report("callbacks/dead", double(m.deadCallbacks));
+        Benchmark::report("bytes/callbacks", double(m.totalBytes()));
+
+        m = title.memory();
+        Benchmark::report("bindings/dead", double(m.deadBindings));
+        Benchmark::report("bytes/bindings", double(m.totalBytes()));
+
+        start = Benchmark::Clock::now();
+        caption.compact();
+        title.compact();
+        Benchmark::report("us/compact", Benchmark::secondsSince(start) * 1e6);
+        Benchmark::report("bytes/callbacks_compacted", double(caption.memory().totalBytes()));
+        Benchmark::report("bytes/bindings_compacted", double(title.memory().totalBytes()));
+    });
+}
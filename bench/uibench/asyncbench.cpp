@@ -0,0 +1,133 @@
+#include "bench/benchmark.h"
+#include "lib/asyncobservable.h"
+#include "lib/threadpool.h"
+#include "lib/valueobservable.h"
+#include <QCoreApplication>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    /*!< Processes the events until done() holds. Returns false on timeout. */
+    template<typename P>
+    bool waitUntil(P done, int timeoutMs = 5000)
+    {
+        auto deadline = Benchmark::Clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (!done())
+        {
+            if (Benchmark::Clock::now() > deadline)
+                return false;
+
+            QCoreApplication::processEvents();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return true;
+    }
+
+    /*!
+     * \brief An AsyncObservable doubling its source on a two-thread pool,
+     *        every job taking 5 ms, or 5 s for inputs of 1000 and more,
+     *        and checking its token every millisecond.
+     *        Checks that a burst of source changes delivers only the latest result,
+     *        that cancel() stops the running job and keeps the value,
+     *        and that a throwing job leaves the value, sets the Failed status
+     *        and is recovered from by the next computation.
+     */
+    Benchmark async("qt.async_observable", []()
+    {
+        std::atomic<int> running(0);
+        std::size_t deliveries = 0;
+        std::size_t staleDeliveries = 0;
+        int expected = 0;
+        int timeouts = 0;
+
+        ValueObservable<int> input(0);
+        ThreadPool pool(2);
+
+        using Async = AsyncObservable<int>;
+        Async doubled([&input, &running]() -> Async::Job
+        {
+            const int n = input.get();
+            if (n == 0)
+                return Async::Job();
+
+            return [n, &running](const AsyncToken& token) -> int
+            {
+                if (n < 0)
+                    throw std::runtime_error("negative input");
+
+                ++running;
+                const int workMs = (n >= 1000) ? 5000 : 5;
+                for (int i = 0; (i < workMs) && !token.cancelled(); ++i)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+                --running;
+                return 2 * n;
+            };
+        }, -1, input);
+
+        doubled.setPool(pool);
+
+        bool fires = doubled.firesOnAddCallback();
+        doubled.setFiresOnAddCallback(false);
+        auto onValue = doubled.addCallback([&](const int& value)
+        {
+            ++deliveries;
+            if (value != expected)
+                ++staleDeliveries;
+        });
+        doubled.setFiresOnAddCallback(fires);
+
+        auto settled = [&doubled]() { return doubled.status().get() != AsyncStatus::Loading; };
+
+        // Supersede: each change cancels the computation of the previous one.
+        const int burst = 100;
+        expected = 2 * burst;
+        auto start = Benchmark::Clock::now();
+        for (int i = 1; i <= burst; ++i)
+            input.set(i);
+
+        timeouts += !waitUntil(settled);
+        Benchmark::report("supersede/seconds", Benchmark::secondsSince(start));
+        Benchmark::report("supersede/deliveries", double(deliveries));
+        Benchmark::report("supersede/stale_deliveries", double(staleDeliveries));
+        Benchmark::report("supersede/value_mismatch", double(doubled.get() != expected));
+        Benchmark::report("supersede/status_mismatch", double(doubled.status().get() != AsyncStatus::Ready));
+
+        // Cancel: a long job is stopped, the previous value stays.
+        deliveries = 0;
+        input.set(1000);
+        timeouts += !waitUntil([&running]() { return running > 0; });
+        start = Benchmark::Clock::now();
+        doubled.cancel();
+        const bool idle = doubled.status().get() == AsyncStatus::Idle;
+        timeouts += !waitUntil([&running]() { return running == 0; });
+        Benchmark::report("cancel/job_stop_ms", 1000 * Benchmark::secondsSince(start));
+
+        // A result posted before the cancellation would arrive by now.
+        waitUntil([]() { return false; }, 20);
+        Benchmark::report("cancel/status_mismatch", double(!idle || (doubled.status().get() != AsyncStatus::Idle)));
+        Benchmark::report("cancel/deliveries", double(deliveries));
+        Benchmark::report("cancel/value_changed", double(doubled.get() != expected));
+
+        // Failed: the exception is kept, the value stays.
+        input.set(-1);
+        timeouts += !waitUntil(settled);
+        Benchmark::report("failed/status_mismatch", double(doubled.status().get() != AsyncStatus::Failed));
+        Benchmark::report("failed/error_missing", double(!doubled.error()));
+        Benchmark::report("failed/value_changed", double(doubled.get() != expected));
+
+        // The next successful computation clears the failure.
+        expected = 8;
+        input.set(4);
+        timeouts += !waitUntil(settled);
+        Benchmark::report("recovered/value_mismatch", double(doubled.get() != expected));
+        Benchmark::report("recovered/status_mismatch", double(doubled.status().get() != AsyncStatus::Ready));
+        Benchmark::report("recovered/error_kept", double(bool(doubled.error())));
+
+        Benchmark::report("timeouts", double(timeouts));
+    });
+}
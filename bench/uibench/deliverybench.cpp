@@ -0,0 +1,74 @@
+#include "bench/benchmark.h"
+#include "lib/concurrentobservable.h"
+#include "lib/queueddelivery.h"
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QThread>
+#include <QTimer>
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace
+{
+    /*!
+     * \brief A 10 kHz producer thread feeds a ConcurrentObservable
+     *        whose GUI-side subscriber is wrapped with deliverOn().
+     *        Reports how many of the produced updates reached the GUI thread,
+     *        and checks that the last delivered value is the last produced one.
+     */
+    Benchmark delivery("qt.queued_delivery", []()
+    {
+        ConcurrentObservable<std::string> shared(std::string(), false);
+        QObject receiver;
+
+        std::size_t delivered = 0;
+        std::string last;
+        bool wrongThread = false;
+        auto handle = shared.addCallback(deliverOn<std::string>(&receiver,
+            [&](const std::string& value)
+            {
+                wrongThread = wrongThread || (QThread::currentThread() != receiver.thread());
+                ++delivered;
+                last = value;
+            }));
+
+        const int produced = 10000;
+        std::atomic<bool> done(false);
+        auto start = Benchmark::Clock::now();
+        std::thread producer([&]()
+        {
+            auto next = Benchmark::Clock::now();
+            for (int i = 1; i <= produced; ++i)
+            {
+                shared.set(std::to_string(i));
+                next += std::chrono::microseconds(100);
+                std::this_thread::sleep_until(next);
+            }
+
+            done = true;
+        });
+
+        QEventLoop loop;
+        QTimer poll;
+        QObject::connect(&poll, &QTimer::timeout, [&]()
+        {
+            if (done)
+                loop.quit();
+        });
+
+        poll.start(10);
+        loop.exec();
+        producer.join();
+
+        // Drain whatever is still queued.
+        QCoreApplication::processEvents();
+
+        Benchmark::report("produced", produced);
+        Benchmark::report("delivered", double(delivered));
+        Benchmark::report("delivered_ratio", double(delivered) / produced);
+        Benchmark::report("seconds", Benchmark::secondsSince(start));
+        Benchmark::report("last_value_mismatch", double(last != std::to_string(produced)));
+        Benchmark::report("wrong_thread_deliveries", double(wrongThread));
+    });
+}
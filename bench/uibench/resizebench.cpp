@@ -0,0 +1,70 @@
+#include "bench/benchmark.h"
+#include "mainview.h"
+#include "mainviewmodel.h"
+#include <QCoreApplication>
+#include <string>
+
+namespace
+{
+    /*!
+     * \brief A synthetic interactive window drag (a resize every 2 ms for a second)
+     *        of a view whose size is two-way bound to its model.
+     *        Reports the model size updates and the main thread time spent on them.
+     */
+    void drag(bool frameAligned, const std::string& name)
+    {
+        MainViewModelPtr vm = MainViewModel::create();
+        vm->initialize();
+
+        MainView view;
+        view.setFrameAligned(frameAligned);
+        view.setViewModel(vm);
+        view.show();
+        QCoreApplication::processEvents();
+
+        std::size_t updates = 0;
+        double modelSeconds = 0;
+        auto subscriber = vm->size().addCallback([&](const Size& size)
+        {
+            // E.g. re-laying out a large model.
+            auto start = Benchmark::Clock::now();
+            doNotOptimize(size.x * size.y);
+            modelSeconds += Benchmark::secondsSince(start);
+            ++updates;
+        });
+
+        updates = 0;
+        modelSeconds = 0;
+
+        const int steps = 500;
+        auto start = Benchmark::Clock::now();
+        for (int i = 0; i < steps; ++i)
+        {
+            view.resize(400 + i, 150 + i / 2);
+
+            auto next = Benchmark::Clock::now() + std::chrono::milliseconds(2);
+            while (Benchmark::Clock::now() < next)
+                QCoreApplication::processEvents();
+        }
+
+        // Let the trailing coalesced update through.
+        auto settle = Benchmark::Clock::now() + std::chrono::milliseconds(100);
+        while (Benchmark::Clock::now() < settle)
+            QCoreApplication::processEvents();
+
+        double elapsed = Benchmark::secondsSince(start);
+        const Size size = vm->size().get();
+        bool synchronized = (size.x == view.width()) && (size.y == view.height());
+
+        Benchmark::report("model_updates/" + name, double(updates));
+        Benchmark::report("model_ms/" + name, modelSeconds * 1e3);
+        Benchmark::report("total_ms/" + name, elapsed * 1e3);
+        Benchmark::report("out_of_sync/" + name, double(!synchronized));
+    }
+
+    Benchmark resize("qt.resize", []()
+    {
+        drag(false, "every_event");
+        drag(true, "frame_aligned");
+    });
+}
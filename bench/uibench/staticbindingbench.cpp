@@ -0,0 +1,81 @@
+#include "bench/benchmark.h"
+#include "lib/staticbinding.h"
+#include "lib/uibinding.h"
+#include "lib/valueobservable.h"
+#include <QLineEdit>
+#include <string>
+
+namespace
+{
+    const int rounds = 20000;
+
+    struct StdToQString
+    {
+        QString operator()(const std::string& str) const { return QString::fromStdString(str); }
+    };
+
+    struct QStringToStd
+    {
+        std::string operator()(const QString& qstr) const { return qstr.toStdString(); }
+    };
+
+    using EditText = Property<QLineEdit, QString, &QLineEdit::text, &QLineEdit::setText>;
+    using EditBinding = StaticBinding<std::string, EditText, StdToQString, QStringToStd>;
+
+    /*!
+     * \brief A model two-way bound to two line edits,
+     *        through UIBinding::bindTwoWay and through StaticBinding.
+     */
+    template<typename Bind>
+    void measure(const std::string& name, Bind bind)
+    {
+        QLineEdit edit1, edit2;
+        ValueObservable<std::string> model("");
+        auto bindings = bind(model, edit1, edit2);
+
+        auto start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+            model.set(std::to_string(i));
+
+        Benchmark::report("ns_per_set/model_to_two_edits/" + name, Benchmark::secondsSince(start) * 1e9 / rounds);
+
+        start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+            edit1.setText(QString::number(-i));
+
+        Benchmark::report("ns_per_keystroke/edit_to_model_and_edit/" + name,
+                          Benchmark::secondsSince(start) * 1e9 / rounds);
+        doNotOptimize(model.get());
+    }
+
+    Benchmark staticBinding("qt.staticbinding", []()
+    {
+        measure("dynamic", [](ValueObservable<std::string>& model, QLineEdit& edit1, QLineEdit& edit2)
+        {
+            using InputBinding = UIBinding<QString>;
+            std::shared_ptr<InputBinding> b1 = std::make_shared<InputBinding>(
+                        [&edit1]() { return edit1.text(); },
+                        [&edit1](QString text) { edit1.setText(text); },
+                        &edit1, &QLineEdit::textChanged);
+            std::shared_ptr<InputBinding> b2 = std::make_shared<InputBinding>(
+                        [&edit2]() { return edit2.text(); },
+                        [&edit2](QString text) { edit2.setText(text); },
+                        &edit2, &QLineEdit::textChanged);
+
+            auto strToQ = [](const std::string& str) { return QString::fromStdString(str); };
+            auto qToStr = [](const QString& qstr) { return qstr.toStdString(); };
+            b1->bindTwoWay(model, strToQ, qToStr);
+            b2->bindTwoWay(model, strToQ, qToStr);
+            return std::make_pair(b1, b2);
+        });
+
+        measure("static", [](ValueObservable<std::string>& model, QLineEdit& edit1, QLineEdit& edit2)
+        {
+            std::shared_ptr<EditBinding> b1 = std::make_shared<EditBinding>();
+            std::shared_ptr<EditBinding> b2 = std::make_shared<EditBinding>();
+            b1->bind(model, &edit1, &edit1, &QLineEdit::textChanged);
+            b2->bind(model, &edit2, &edit2, &QLineEdit::textChanged);
+            return std::make_pair(b1, b2);
+        });
+    });
+}
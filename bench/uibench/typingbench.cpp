@@ -0,0 +1,86 @@
+#include "bench/benchmark.h"
+#include "lib/uibinding.h"
+#include "lib/valueobservable.h"
+#include <QCoreApplication>
+#include <QLineEdit>
+#include <functional>
+#include <string>
+
+namespace
+{
+    using InputBinding = UIBinding<QString>;
+    using Policy = InputBinding::UpdatePolicy;
+
+    /*!
+     * \brief Synthetic fast typing (one keystroke every 2 ms) into a line edit
+     *        two-way bound to a large text model with an expensive subscriber.
+     *        Reports the updates that reached the model and the main thread time spent on them.
+     */
+    void type(Policy policy, int msec, const std::string& name)
+    {
+        QLineEdit edit;
+        InputBinding binding([&]() { return edit.text(); },
+                             [&](QString text) { edit.setText(text); },
+                             &edit, &QLineEdit::textChanged);
+
+        if (policy == Policy::OnCommit)
+            binding.commitOn(&edit, &QLineEdit::editingFinished);
+        else
+            binding.setUpdatePolicy(policy, msec);
+
+        ValueObservable<std::string> model(std::string(100000, 'x'));
+        binding.bindTwoWay(model,
+                           [](const std::string& str) { return QString::fromStdString(str); },
+                           [](const QString& qstr) { return qstr.toStdString(); });
+
+        std::size_t updates = 0;
+        double modelSeconds = 0;
+        auto subscriber = model.addCallback([&](const std::string& text)
+        {
+            // E.g. re-rendering or re-indexing the whole model.
+            auto start = Benchmark::Clock::now();
+            std::size_t hash = std::hash<std::string>()(text);
+            doNotOptimize(hash);
+            modelSeconds += Benchmark::secondsSince(start);
+            ++updates;
+        });
+
+        updates = 0;
+        modelSeconds = 0;
+
+        const int keystrokes = 500;
+        auto start = Benchmark::Clock::now();
+        for (int i = 0; i < keystrokes; ++i)
+        {
+            edit.insert(QString(QChar('a' + i % 26)));
+
+            auto next = Benchmark::Clock::now() + std::chrono::milliseconds(2);
+            while (Benchmark::Clock::now() < next)
+                QCoreApplication::processEvents();
+        }
+
+        if (policy == Policy::OnCommit)
+            emit edit.editingFinished();
+
+        // Let the trailing debounced or throttled update through.
+        auto settle = Benchmark::Clock::now() + std::chrono::milliseconds(msec + 50);
+        while (Benchmark::Clock::now() < settle)
+            QCoreApplication::processEvents();
+
+        double elapsed = Benchmark::secondsSince(start);
+        bool synchronized = (QString::fromStdString(model.get()) == edit.text());
+
+        Benchmark::report("model_updates/" + name, double(updates));
+        Benchmark::report("model_ms/" + name, modelSeconds * 1e3);
+        Benchmark::report("total_ms/" + name, elapsed * 1e3);
+        Benchmark::report("out_of_sync/" + name, double(!synchronized));
+    }
+
+    Benchmark typing("qt.typing", []()
+    {
+        type(Policy::Immediate, 0, "immediate");
+        type(Policy::Debounce, 100, "debounce_100ms");
+        type(Policy::Throttle, 50, "throttle_50ms");
+        type(Policy::OnCommit, 0, "on_commit");
+    });
+}
@@ -0,0 +1,36 @@
+#-------------------------------------------------
+#
+# Benchmarks for the Qt-dependent parts of lib/.
+# Run headless: the offscreen platform is selected by default.
+#
+#-------------------------------------------------
+
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TEMPLATE = app
+TARGET = observable-uibench
+
+CONFIG += console thread c++11
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+        ../../mainview.cpp \
+        ../../mainviewmodel.cpp \
+        ../benchmark.cpp \
+        asyncbench.cpp \
+        deliverybench.cpp \
+        main.cpp \
+        resizebench.cpp \
+        staticbindingbench.cpp \
+        typingbench.cpp \
+        uibindingbench.cpp \
+        viewbench.cpp
+
+HEADERS += \
+        ../../mainview.h \
+        ../../mainviewmodel.h \
+        ../benchmark.h
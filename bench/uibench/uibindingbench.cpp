@@ -0,0 +1,52 @@
+#include "bench/benchmark.h"
+#include "lib/uibinding.h"
+#include "lib/valueobservable.h"
+#include <QLineEdit>
+#include <string>
+
+namespace
+{
+    const int rounds = 20000;
+
+    /*!
+     * \brief UIBinding over a QLineEdit: set() latency,
+     *        and a model change propagated through bindTwoWay to two line edits.
+     */
+    Benchmark uiBinding("qt.uibinding", []()
+    {
+        QLineEdit edit1, edit2;
+        UIBinding<QString> binding1([&]() { return edit1.text(); },
+                                    [&](QString text) { edit1.setText(text); },
+                                    &edit1, &QLineEdit::textChanged);
+        UIBinding<QString> binding2([&]() { return edit2.text(); },
+                                    [&](QString text) { edit2.setText(text); },
+                                    &edit2, &QLineEdit::textChanged);
+
+        auto start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+            binding1.set(QString::number(i));
+
+        Benchmark::report("ns_per_set/line_edit", Benchmark::secondsSince(start) * 1e9 / rounds);
+
+        ValueObservable<std::string> model("");
+        auto strToQ = [](const std::string& str) { return QString::fromStdString(str); };
+        auto qToStr = [](const QString& qstr) { return qstr.toStdString(); };
+        binding1.bindTwoWay(model, strToQ, qToStr);
+        binding2.bindTwoWay(model, strToQ, qToStr);
+
+        start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+            model.set(std::to_string(i));
+
+        Benchmark::report("ns_per_set/model_to_two_edits", Benchmark::secondsSince(start) * 1e9 / rounds);
+
+        // Typing into one edit updates the model and the other edit.
+        start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+            edit1.setText(QString::number(-i));
+
+        Benchmark::report("ns_per_keystroke/edit_to_model_and_edit",
+                          Benchmark::secondsSince(start) * 1e9 / rounds);
+        doNotOptimize(model.get());
+    });
+}
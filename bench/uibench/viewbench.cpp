@@ -0,0 +1,45 @@
+#include "bench/benchmark.h"
+#include "mainview.h"
+#include "mainviewmodel.h"
+#include <QCoreApplication>
+
+namespace
+{
+    /*!
+     * \brief MainView construction and view model binding,
+     *        and a view model change propagated to the bound view.
+     */
+    Benchmark view("qt.view", []()
+    {
+        MainViewModelPtr vm = std::make_shared<MainViewModel>();
+        vm->initialize();
+
+        const int views = 200;
+        auto start = Benchmark::Clock::now();
+        for (int i = 0; i < views; ++i)
+        {
+            MainView view;
+            view.setViewModel(vm->clone());
+        }
+
+        Benchmark::report("us_per_view_with_model", Benchmark::secondsSince(start) * 1e6 / views);
+
+        MainView view;
+        view.setViewModel(vm);
+        view.show();
+        QCoreApplication::processEvents();
+
+        const int rounds = 20000;
+        start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+            vm->text().set(std::to_string(i));
+
+        Benchmark::report("ns_per_set/model_text_to_view", Benchmark::secondsSince(start) * 1e9 / rounds);
+
+        start = Benchmark::Clock::now();
+        for (int i = 0; i < rounds; ++i)
+            vm->size().set(Size(300 + i % 100, 200));
+
+        Benchmark::report("ns_per_set/model_size_to_view", Benchmark::secondsSince(start) * 1e9 / rounds);
+    });
+}
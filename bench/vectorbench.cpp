@@ -0,0 +1,89 @@
+#include "benchmark.h"
+#include "lib/observablevector.h"
+#include "lib/valueobservable.h"
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Rows = std::vector<std::string>;
+
+    const std::size_t rowCount = 10000;
+    const int rounds = 1000;
+
+    Rows makeRows()
+    {
+        Rows rows;
+        for (std::size_t i = 0; i < rowCount; ++i)
+            rows.push_back("row " + std::to_string(i));
+
+        return rows;
+    }
+
+    /*!
+     * \brief Editing a single row of a list model,
+     *        the way it is done with a whole-vector observable and with ObservableVector.
+     *        The consumer stands for a view, refreshing every row it is told about.
+     */
+    Benchmark edits("vector.edits", []()
+    {
+        std::size_t refreshed = 0;
+
+        {
+            ValueObservable<Rows> model(makeRows());
+            auto h = model.addCallback([&refreshed](const Rows& rows) { refreshed += rows.size(); });
+            refreshed = 0;
+
+            auto start = Benchmark::Clock::now();
+            for (int i = 0; i < rounds; ++i)
+            {
+                Rows rows = model.get();
+                rows[i % rowCount] = "edited " + std::to_string(i);
+                model.set(std::move(rows));
+            }
+
+            Benchmark::report("us_per_edit/value_observable", Benchmark::secondsSince(start) * 1e6 / rounds);
+            Benchmark::report("rows_refreshed_per_edit/value_observable", double(refreshed) / rounds);
+        }
+
+        {
+            ObservableVector<std::string> model(makeRows());
+            auto h = model.changes().addCallback([&refreshed](const VectorChanges& changes) {
+                for (const VectorChange& c : changes)
+                    refreshed += c.count;
+            });
+            refreshed = 0;
+
+            auto start = Benchmark::Clock::now();
+            for (int i = 0; i < rounds; ++i)
+                model.update(i % rowCount, "edited " + std::to_string(i));
+
+            Benchmark::report("us_per_edit/observable_vector", Benchmark::secondsSince(start) * 1e6 / rounds);
+            Benchmark::report("rows_refreshed_per_edit/observable_vector", double(refreshed) / rounds);
+        }
+
+        doNotOptimize(refreshed);
+    });
+
+    Benchmark batched("vector.batched_appends", []()
+    {
+        ObservableVector<std::string> model;
+        std::size_t notifications = 0;
+        std::size_t records = 0;
+        auto h = model.changes().addCallback([&](const VectorChanges& changes) {
+            ++notifications;
+            records += changes.size();
+        });
+
+        auto start = Benchmark::Clock::now();
+        {
+            ObservableBatch batch;
+            for (std::size_t i = 0; i < rowCount; ++i)
+                model.append("row " + std::to_string(i));
+        }
+
+        Benchmark::report("ns_per_append", Benchmark::secondsSince(start) * 1e9 / rowCount);
+        Benchmark::report("notifications", double(notifications));
+        Benchmark::report("records", double(records));
+    });
+}
@@ -35,9 +35,9 @@ public:
 
 protected:
 
-    void doSet(T& value)
+    void doSet(T&& value)
     {
-        _setter(value);
+        _setter(std::move(value));
     }
 
 private:
@@ -0,0 +1,245 @@
+#ifndef ASYNCOBSERVABLE_H
+#define ASYNCOBSERVABLE_H
+
+#include <QMetaObject>
+#include <QObject>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "observable.h"
+#include "threadpool.h"
+#include "valueobservable.h"
+
+/*!
+ * \brief The state of the computation of an AsyncObservable.
+ */
+enum class AsyncStatus
+{
+    Idle,    /*!< Nothing has been computed yet, or the computation was cancelled. */
+    Loading, /*!< A computation is running, the value is that of the previous one. */
+    Ready,   /*!< The value is the result of the latest computation. */
+    Failed   /*!< The latest computation has thrown, see AsyncObservable::error(). */
+};
+
+/*!
+ * \brief A cancellation flag shared by an AsyncObservable and one of its jobs.
+ *        A long job should check it now and then, and give up once it is set:
+ *        whatever a cancelled job returns is dropped.
+ */
+class AsyncToken
+{
+public:
+    AsyncToken() : _cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+    bool cancelled() const { return _cancelled->load(std::memory_order_relaxed); }
+    void cancel() const { _cancelled->store(true, std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> _cancelled;
+};
+
+/*!
+ * \brief A read-only observable whose value is computed on a ThreadPool,
+ *        e.g. a file loaded or an image scaled, so that the work does not block the event loop.
+ *
+ *        The launch function runs on the owning thread, where it may read observables,
+ *        and returns the job to run on the pool, capturing what the job needs by value:
+ *
+ *        AsyncObservable<QImage> thumbnail([&]() -> AsyncObservable<QImage>::Job {
+ *            QString path = file.get();
+ *            return [path](const AsyncToken& token) { return loadThumbnail(path, token); };
+ *        }, QImage(), file);
+ *
+ *        A change of any source starts a new computation, cancelling the running one.
+ *        The result is delivered on the thread that has created the observable,
+ *        together with the status, see status(), within a single batch.
+ *        That thread owns the observable: it must run a Qt event loop,
+ *        and the observable must only be used and destroyed there.
+ *        An empty job means there is nothing to compute, and sets the status to Idle.
+ *
+ *        set() is ignored, since the value is defined by the jobs.
+ *        The sources must outlive the observable.
+ */
+template<typename T>
+class AsyncObservable : public Observable<T>
+{
+public:
+    using Base = Observable<T>;
+    using Job = std::function<T (const AsyncToken& token)>;
+    using Launch = std::function<Job ()>;
+
+    template<typename... S>
+    AsyncObservable(Launch launch, T initial, Observable<S>&... sources);
+
+    ~AsyncObservable()
+    {
+        _token.cancel();
+
+        // A job finishing from now on neither posts nor finds the observable.
+        // The results posted already are dropped along with the receiver.
+        std::lock_guard<std::mutex> lock(_channel->mutex);
+        _channel->receiver = nullptr;
+        _channel->owner = nullptr;
+    }
+
+    AsyncObservable(const AsyncObservable&) = delete;
+    AsyncObservable& operator=(const AsyncObservable&) = delete;
+
+    T get() { return _value; }
+
+    void set(T) {}
+
+    Observable<AsyncStatus>& status() { return _status; }
+
+    bool loading() const { return _status.value() == AsyncStatus::Loading; }
+
+    /*!< The exception thrown by the latest job, if the status is Failed. */
+    std::exception_ptr error() const { return _error; }
+
+    /*!< The pool to run the next jobs on, the shared one by default. */
+    void setPool(ThreadPool& pool) { _pool = &pool; }
+
+    /*!< Starts a new computation, cancelling the running one. */
+    void reload();
+
+    /*!< Cancels the running computation, keeping the value. */
+    void cancel();
+
+protected:
+    void doSet(T&& value) { _value = std::move(value); }
+    const T *stored() { return &_value; }
+
+private:
+    /*!
+     * \brief What the jobs share with the observable.
+     *        The receiver is guarded by the mutex, the owner is only accessed on its thread,
+     *        where the results are delivered.
+     */
+    struct Channel
+    {
+        std::mutex mutex;
+        QObject *receiver;
+        AsyncObservable *owner;
+    };
+
+    template<typename S>
+    void dependOn(Observable<S>& source)
+    {
+        bool fires = source.firesOnAddCallback();
+        source.setFiresOnAddCallback(false);
+        _sources.push_back(source.addCallback([this](const S&) { reload(); }));
+        source.setFiresOnAddCallback(fires);
+    }
+
+    void finish(std::uint64_t generation, const std::shared_future<T>& result);
+
+    Launch _launch;
+    T _value;
+    ValueObservable<AsyncStatus> _status;
+    std::exception_ptr _error;
+    std::shared_ptr<Channel> _channel;
+
+    /*!< Lives on the owner's thread, so that the results posted to it are delivered there. */
+    std::unique_ptr<QObject> _receiver;
+    ThreadPool *_pool;
+    AsyncToken _token;
+
+    /*!< Identifies the latest computation, so that the superseded results are dropped. */
+    std::uint64_t _generation;
+
+    std::vector<Subscription> _sources;
+};
+
+template<typename T>
+template<typename... S>
+AsyncObservable<T>::AsyncObservable(Launch launch, T initial, Observable<S>&... sources) :
+    Base(true), _launch(std::move(launch)), _value(std::move(initial)), _status(AsyncStatus::Idle),
+    _channel(std::make_shared<Channel>()), _receiver(new QObject()), _pool(&ThreadPool::shared()), _generation(0)
+{
+    _channel->receiver = _receiver.get();
+    _channel->owner = this;
+
+    int expand[] = { 0, (dependOn(sources), 0)... };
+    (void)expand;
+
+    reload();
+}
+
+template<typename T>
+void AsyncObservable<T>::reload()
+{
+    _token.cancel();
+    _token = AsyncToken();
+    const std::uint64_t generation = ++_generation;
+
+    Job job = _launch ? _launch() : Job();
+    if (!job)
+    {
+        _status.set(AsyncStatus::Idle);
+        return;
+    }
+
+    _status.set(AsyncStatus::Loading);
+
+    std::shared_ptr<Channel> channel = _channel;
+    AsyncToken token = _token;
+    _pool->submit([channel, job, token, generation]()
+    {
+        std::packaged_task<T ()> task([&job, &token]() { return job(token); });
+        std::shared_future<T> result = task.get_future().share();
+        task();
+
+        std::lock_guard<std::mutex> lock(channel->mutex);
+        if (!channel->receiver || token.cancelled())
+            return;
+
+        QMetaObject::invokeMethod(channel->receiver, [channel, generation, result]()
+        {
+            if (channel->owner)
+                channel->owner->finish(generation, result);
+        }, Qt::QueuedConnection);
+    });
+}
+
+template<typename T>
+void AsyncObservable<T>::cancel()
+{
+    if (_status.value() != AsyncStatus::Loading)
+        return;
+
+    _token.cancel();
+    ++_generation;
+    _status.set(AsyncStatus::Idle);
+}
+
+template<typename T>
+void AsyncObservable<T>::finish(std::uint64_t generation, const std::shared_future<T>& result)
+{
+    if (generation != _generation)
+        return;
+
+    std::exception_ptr error;
+    try
+    {
+        result.get();
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    // The callbacks of the value see the new status, and the other way around.
+    ObservableBatch batch;
+    _error = error;
+    if (!error)
+        Base::set(result.get());
+
+    _status.set(error ? AsyncStatus::Failed : AsyncStatus::Ready);
+}
+
+#endif // ASYNCOBSERVABLE_H
@@ -0,0 +1,118 @@
+#ifndef ATOMICSNAPSHOT_H
+#define ATOMICSNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/*!
+ * \brief An atomically replaceable std::shared_ptr<const T> whose load() is wait-free.
+ *
+ *        std::atomic_load() and std::atomic_store() of a shared_ptr take a lock
+ *        from a global pool in libstdc++, so readers contend with writers and with each other.
+ *        Here the shared_ptr is kept in a holder, and the word pointing to the holder
+ *        also counts the loads that have acquired it (split reference counting):
+ *        a load takes a fetch_add on the word, copies the shared_ptr
+ *        and releases the holder with one more atomic operation, without looping or locking.
+ *        A store swaps in a new holder and adds the count collected by the old one
+ *        to the old holder's own count, so that whichever of the loads and the store
+ *        is the last to leave the holder frees it.
+ *
+ *        The holder address and the count share 64 bits, so user space addresses
+ *        must fit into 48 bits, as on x86-64 and AArch64.
+ *        Without stores the count would eventually overflow, so once every 65536 loads
+ *        a load swaps in a fresh holder of the same snapshot, allocating it.
+ */
+template<typename T>
+class AtomicSnapshot
+{
+public:
+    using Snapshot = std::shared_ptr<const T>;
+
+    explicit AtomicSnapshot(Snapshot snapshot) : _word(pack(new Holder(std::move(snapshot)))) {}
+
+    AtomicSnapshot(const AtomicSnapshot&) = delete;
+    AtomicSnapshot& operator=(const AtomicSnapshot&) = delete;
+
+    ~AtomicSnapshot() { retire(_word.load()); }
+
+    /*!< Returns the current snapshot. Wait-free. */
+    Snapshot load() const;
+
+    /*!< Replaces the snapshot. The loads running meanwhile return either the old one or the new one. */
+    void store(Snapshot snapshot) { retire(_word.exchange(pack(new Holder(std::move(snapshot))))); }
+
+private:
+    static_assert(sizeof(void *) == 8, "AtomicSnapshot needs 64-bit pointers");
+
+    // The holders are 16-byte aligned, so the address loses 4 bits and fits into 44,
+    // leaving 20 bits to the count.
+    static const int countShift = 44;
+    static const std::uint64_t one = std::uint64_t(1) << countShift;
+    static const std::uint64_t resetCount = std::uint64_t(1) << 16;
+
+    struct alignas(16) Holder
+    {
+        explicit Holder(Snapshot s) : snapshot(std::move(s)), released(0) {}
+
+        Snapshot snapshot;
+
+        /*!< The loads released minus the loads counted by retire(), frees the holder at 0. */
+        std::atomic<std::int64_t> released;
+    };
+
+    static std::uint64_t pack(Holder *holder)
+    {
+        return std::uint64_t(reinterpret_cast<std::uintptr_t>(holder)) >> 4;
+    }
+
+    static Holder *holderOf(std::uint64_t word)
+    {
+        return reinterpret_cast<Holder *>(std::uintptr_t((word & (one - 1)) << 4));
+    }
+
+    static std::int64_t countOf(std::uint64_t word) { return std::int64_t(word >> countShift); }
+
+    /*!< Called by a load done with the holder. */
+    static void release(Holder *holder)
+    {
+        if (holder->released.fetch_add(1) == -1)
+            delete holder;
+    }
+
+    /*!< Called once the holder is swapped out, with the word holding its count of loads. */
+    static void retire(std::uint64_t word)
+    {
+        Holder *holder = holderOf(word);
+        const std::int64_t count = countOf(word);
+        if (holder->released.fetch_sub(count) == count)
+            delete holder;
+    }
+
+    mutable std::atomic<std::uint64_t> _word;
+};
+
+template<typename T>
+typename AtomicSnapshot<T>::Snapshot AtomicSnapshot<T>::load() const
+{
+    const std::uint64_t word = _word.fetch_add(one) + one;
+    Holder *holder = holderOf(word);
+    Snapshot snapshot = holder->snapshot;
+
+    if (countOf(word) >= std::int64_t(resetCount))
+    {
+        // A single attempt: if the word has changed meanwhile, another load or a store
+        // has swapped the holder, or one of the next loads past the count will.
+        Holder *fresh = new Holder(snapshot);
+        std::uint64_t expected = _word.load();
+        if ((holderOf(expected) == holder) && _word.compare_exchange_strong(expected, pack(fresh)))
+            retire(expected);
+        else
+            delete fresh;
+    }
+
+    release(holder);
+    return snapshot;
+}
+
+#endif // ATOMICSNAPSHOT_H
@@ -0,0 +1,95 @@
+#ifndef BINARYCODEC_H
+#define BINARYCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+/*!
+ * \brief Converts values of a type to and from the bytes stored by ObservableFields::save().
+ *
+ *        Trivially copyable types are stored as they are in memory,
+ *        strings as their characters. Raw pointers are not supported,
+ *        an address is meaningless once loaded; neither should be the structs holding them,
+ *        which a specialization with supported = false excludes.
+ *        Other types may be supported by a specialization with the same members:
+ *
+ *        template<> struct BinaryCodec<Color>
+ *        {
+ *            static const bool supported = true;
+ *            static void write(const Color& value, std::vector<char>& out);
+ *            static bool fits(std::size_t size);
+ *            static Color read(const char *data, std::size_t size);
+ *        };
+ *
+ *        read() is only given sizes accepted by fits().
+ *        The bytes are in the native byte order, meant to be read by the same build.
+ */
+template<typename T, typename Enable = void>
+struct BinaryCodec
+{
+    static const bool supported = false;
+};
+
+template<typename T>
+struct BinaryCodec<T, typename std::enable_if<std::is_trivially_copyable<T>::value
+                                              && !std::is_pointer<T>::value>::type>
+{
+    static const bool supported = true;
+
+    static void write(const T& value, std::vector<char>& out)
+    {
+        const char *bytes = reinterpret_cast<const char *>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    static bool fits(std::size_t size) { return size == sizeof(T); }
+
+    static T read(const char *data, std::size_t)
+    {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        std::memcpy(&storage, data, sizeof(T));
+        return *reinterpret_cast<const T *>(&storage);
+    }
+};
+
+template<>
+struct BinaryCodec<std::string>
+{
+    static const bool supported = true;
+
+    static void write(const std::string& value, std::vector<char>& out)
+    {
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    static bool fits(std::size_t) { return true; }
+
+    static std::string read(const char *data, std::size_t size) { return std::string(data, size); }
+};
+
+/*!
+ * \brief Identifies a type in the stored bytes, so that a value is never read as another type.
+ *        Derived from the implementation's type name, hence only stable within a build.
+ */
+template<typename T>
+std::uint32_t binaryTypeTag()
+{
+    static const std::uint32_t tag = []()
+    {
+        // FNV-1a
+        std::uint32_t h = 2166136261u;
+        for (const char *c = typeid(T).name(); *c; ++c)
+            h = (h ^ std::uint32_t(static_cast<unsigned char>(*c))) * 16777619u;
+
+        return h ? h : 1u;
+    }();
+
+    return tag;
+}
+
+#endif // BINARYCODEC_H
@@ -0,0 +1,39 @@
+#ifndef CHANGESTREAM_H
+#define CHANGESTREAM_H
+
+#include <utility>
+#include "observable.h"
+
+/*!
+ * \brief An observable delivering the change records of a container,
+ *        e.g. ObservableVector or ObservableMap.
+ *        Callbacks are passed the records of a single notification
+ *        and are not fired upon adding. set() is ignored.
+ */
+template<typename Changes>
+class ChangeStream : public Observable<Changes>
+{
+public:
+    ChangeStream() : Observable<Changes>(false) {}
+
+    /*!< The records of the last delivered change. */
+    Changes get() { return _last; }
+
+    void set(Changes) {}
+
+    /*!< Notifies the callbacks of the records. Used by the owning container. */
+    void deliver(Changes&& changes)
+    {
+        _last = std::move(changes);
+        this->onChange(_last);
+    }
+
+protected:
+    void doSet(Changes&&) {}
+    const Changes *stored() { return &_last; }
+
+private:
+    Changes _last;
+};
+
+#endif // CHANGESTREAM_H
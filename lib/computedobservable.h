@@ -0,0 +1,188 @@
+#ifndef COMPUTEDOBSERVABLE_H
+#define COMPUTEDOBSERVABLE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "observable.h"
+#include "propagation.h"
+
+/*!
+ * \brief A read-only observable derived from a number of source observables.
+ *
+ *        The value is computed lazily and memoized: a source change only marks it
+ *        and the computed values depending on it stale.
+ *        It is recomputed when read, or, if it has live callbacks,
+ *        after the notification of the source change is over.
+ *        A read compares the versions of the sources with those the value was computed from,
+ *        so it is up to date even while the notification is deferred,
+ *        e.g. by an ObservableBatch or a NotificationScheduler.
+ *        In the latter case the recomputation is ordered by the depth in the dependency graph,
+ *        so in a diamond (A -> B, A -> C, B + C -> D) D is recomputed once per change of A,
+ *        and never sees B updated while C is not.
+ *
+ *        ComputedObservable<std::string> title(
+ *            [&]() { return caption.get() + ": " + text.get(); },
+ *            caption, text);
+ *
+ *        set() is ignored, since the value is defined by the sources.
+ *        The sources must outlive the computed observable.
+ */
+template<typename T>
+class ComputedObservable : public Observable<T>, public PropagationNode
+{
+public:
+    using Base = Observable<T>;
+    using Compute = std::function<T ()>;
+
+    template<typename... S>
+    ComputedObservable(Compute compute, Observable<S>&... sources) :
+        Base(true), _compute(std::move(compute)), _dirty(true), _unnotified(false)
+    {
+        int expand[] = { 0, (dependOn(sources), 0)... };
+        (void)expand;
+    }
+
+    ComputedObservable(const ComputedObservable&) = delete;
+    ComputedObservable& operator=(const ComputedObservable&) = delete;
+
+    T get() { return *stored(); }
+
+    void set(T) {}
+
+    /*!
+     * \brief Whether the memoized value is known to be out of date.
+     *        A source change whose notification is deferred is only detected by a read.
+     */
+    bool dirty() const { return _dirty; }
+
+    /*!< Recomputes the value, if a source has changed since it was computed. */
+    void refresh();
+
+    void invalidate()
+    {
+        _dirty = true;
+        if (this->hasCallbacks())
+            schedule();
+
+        invalidateDependents();
+    }
+
+protected:
+    void doSet(T&&) {}
+
+    const T *stored()
+    {
+        refresh();
+        return _value.get();
+    }
+
+    void propagate()
+    {
+        // The first value is news to the callbacks, unless they have already read it.
+        bool first = !_value;
+        refresh();
+        if (!first && !_unnotified)
+            return;
+
+        _unnotified = false;
+        this->onChange(*_value);
+    }
+
+private:
+    /*!< The version of a source, and the one the value was computed from. */
+    struct Input
+    {
+        std::uint64_t (*version)(void *source);
+        void *source;
+        std::uint64_t seen;
+    };
+
+    template<typename S>
+    static std::uint64_t sourceVersion(void *source)
+    {
+        return static_cast<Observable<S> *>(source)->version();
+    }
+
+    template<typename S>
+    static std::uint64_t computedVersion(void *source)
+    {
+        ComputedObservable<S> *computed = static_cast<ComputedObservable<S> *>(source);
+        computed->refresh();
+        return computed->version();
+    }
+
+    template<typename S>
+    void dependOn(Observable<S>& source)
+    {
+        // Computed sources invalidate their dependents directly,
+        // so that they do not have to be recomputed just to notify them.
+        // Their versions are only meaningful once they are up to date.
+        if (ComputedObservable<S> *computed = dynamic_cast<ComputedObservable<S> *>(&source))
+        {
+            PropagationNode::dependOn(computed);
+            _inputs.push_back(Input { &computedVersion<S>, computed, 0 });
+            return;
+        }
+
+        _inputs.push_back(Input { &sourceVersion<S>, &source, 0 });
+        setHeight(std::max(height(), 1u));
+
+        // Subscribing must not read the source value, so firing on add is suppressed.
+        bool fires = source.firesOnAddCallback();
+        source.setFiresOnAddCallback(false);
+        _sources.push_back(source.addCallback([this](const S&) { invalidate(); }));
+        source.setFiresOnAddCallback(fires);
+    }
+
+    /*!< Takes the current versions of the sources. Returns whether any has changed. */
+    bool inputsChanged()
+    {
+        bool changed = false;
+        for (Input& input : _inputs)
+        {
+            const std::uint64_t version = input.version(input.source);
+            changed = changed || (version != input.seen);
+            input.seen = version;
+        }
+
+        return changed;
+    }
+
+    Compute _compute;
+    std::vector<Input> _inputs;
+    std::unique_ptr<T> _value;
+    std::vector<Subscription> _sources;
+    bool _dirty;
+    bool _unnotified;
+};
+
+template<typename T>
+void ComputedObservable<T>::refresh()
+{
+    // The versions are checked even when the value is not marked stale,
+    // as the notification marking it may have been deferred.
+    if (!inputsChanged() && _value)
+    {
+        _dirty = false;
+        return;
+    }
+
+    _dirty = false;
+    T value = _compute();
+    if (!_value)
+    {
+        _value.reset(new T(std::move(value)));
+        this->touch();
+    }
+    else if (!this->unchanged(value, _value.get()))
+    {
+        *_value = std::move(value);
+        this->touch();
+        _unnotified = true;
+    }
+}
+
+#endif // COMPUTEDOBSERVABLE_H
@@ -0,0 +1,161 @@
+#ifndef CONCURRENTOBSERVABLE_H
+#define CONCURRENTOBSERVABLE_H
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "atomicsnapshot.h"
+
+/*!
+ * \brief A thread-safe observable value.
+ *        The value is kept in an immutable shared snapshot
+ *        that is replaced atomically on every change, see AtomicSnapshot:
+ *        reading is wait-free, so readers never wait for writers or for each other,
+ *        and may keep a snapshot as long as they like.
+ *        set() may be called from any thread. Changes are serialized,
+ *        and the callbacks run on the setting thread, in the order the changes were made.
+ *        The subscriber list is copy-on-write, so callbacks may be added and removed
+ *        from any thread while a notification is running.
+ *        A callback removed during a notification may still receive that last notification.
+ *
+ *        Unlike Observable, this class takes no part in bindings:
+ *        it is meant to be the source of data produced on worker threads.
+ */
+template<typename T>
+class ConcurrentObservable
+{
+public:
+    using Snapshot = std::shared_ptr<const T>;
+
+    /*!
+     * \brief Constructor
+     * \param firesOnAddCallback controls
+     *        whether the observable executes a callback immediately upon adding.
+     */
+    ConcurrentObservable(T value, bool firesOnAddCallback = true) :
+        _value(std::make_shared<const T>(std::move(value))),
+        _callbacks(std::make_shared<const Callbacks>()),
+        _fireOnAdd(firesOnAddCallback) {}
+
+    ConcurrentObservable(const ConcurrentObservable&) = delete;
+    ConcurrentObservable& operator=(const ConcurrentObservable&) = delete;
+
+    bool firesOnAddCallback() const { return _fireOnAdd; }
+
+    /*!< Get a copy of the current value. */
+    T get() const { return *snapshot(); }
+
+    /*!< Get the current value snapshot. Wait-free. */
+    Snapshot snapshot() const { return _value.load(); }
+
+    /*!< Set a new value from any thread. The callbacks run on the calling thread. */
+    void set(T value);
+
+    using Callback = std::function<void (const T& newV)>;
+    using CallbackPtr = std::shared_ptr<Callback>;
+
+    /*!
+     * \brief Add a callback to be executed after a new value was set.
+     *        As with Observable, the callback lives as long as the returned handle does.
+     *        If the observable fires on adding, the call is serialized with changes,
+     *        so the callback never receives an older value after a newer one.
+     */
+    template<typename F>
+    CallbackPtr addCallback(F block);
+
+    /*!< Removes a callback from the observable's list. */
+    void removeCallback(const CallbackPtr& callback);
+
+private:
+    using StoredCallbackPtr = std::weak_ptr<Callback>;
+    using Callbacks = std::vector<StoredCallbackPtr>;
+    using CallbacksPtr = std::shared_ptr<const Callbacks>;
+
+    /*!< Replaces the subscriber list with a modified copy, dropping dead entries. */
+    template<typename M>
+    void modifyCallbacks(M modify);
+
+    AtomicSnapshot<T> _value;
+    AtomicSnapshot<Callbacks> _callbacks;
+    bool _fireOnAdd;
+
+    /*!< Serializes changes and their notifications. Recursive, so callbacks may set the value again. */
+    std::recursive_mutex _writeMutex;
+
+    /*!< Serializes the subscriber list modifications. */
+    std::mutex _subscribeMutex;
+};
+
+template<typename T>
+void ConcurrentObservable<T>::set(T value)
+{
+    std::lock_guard<std::recursive_mutex> lock(_writeMutex);
+
+    Snapshot current = _value.load();
+    if (!(value != *current))
+        return;
+
+    Snapshot next = std::make_shared<const T>(std::move(value));
+    _value.store(next);
+
+    CallbacksPtr callbacks = _callbacks.load();
+    for (const StoredCallbackPtr& stored : *callbacks)
+    {
+        if (CallbackPtr pCallback = stored.lock())
+            pCallback->operator()(*next);
+    }
+}
+
+template<typename T>
+template<typename F>
+typename ConcurrentObservable<T>::CallbackPtr ConcurrentObservable<T>::addCallback(F block)
+{
+    CallbackPtr onUpdate = std::make_shared<Callback>(std::move(block));
+    if (!_fireOnAdd)
+    {
+        modifyCallbacks([&onUpdate](Callbacks& callbacks) { callbacks.emplace_back(onUpdate); });
+        return onUpdate;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(_writeMutex);
+    modifyCallbacks([&onUpdate](Callbacks& callbacks) { callbacks.emplace_back(onUpdate); });
+    onUpdate->operator()(*snapshot());
+    return onUpdate;
+}
+
+template<typename T>
+void ConcurrentObservable<T>::removeCallback(const CallbackPtr& callback)
+{
+    modifyCallbacks([&callback](Callbacks& callbacks)
+    {
+        callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(),
+                                       [&callback](const StoredCallbackPtr& e)
+                                       {
+                                           return e.lock() == callback;
+                                       }),
+                        callbacks.end());
+    });
+}
+
+template<typename T>
+template<typename M>
+void ConcurrentObservable<T>::modifyCallbacks(M modify)
+{
+    std::lock_guard<std::mutex> lock(_subscribeMutex);
+
+    CallbacksPtr current = _callbacks.load();
+    std::shared_ptr<Callbacks> next = std::make_shared<Callbacks>();
+    next->reserve(current->size() + 1);
+    for (const StoredCallbackPtr& e : *current)
+    {
+        if (!e.expired())
+            next->push_back(e);
+    }
+
+    modify(*next);
+    _callbacks.store(CallbacksPtr(next));
+}
+
+#endif // CONCURRENTOBSERVABLE_H
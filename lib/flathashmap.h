@@ -0,0 +1,197 @@
+#ifndef FLATHASHMAP_H
+#define FLATHASHMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/*!
+ * \brief An open addressing hash map with linear probing.
+ *        The entries are kept in a single flat array, so a lookup
+ *        usually touches one or two adjacent cache lines, and there is no allocation per entry.
+ *        Erasing shifts the following entries back instead of leaving tombstones.
+ *
+ *        The key and value types must be default constructible and movable.
+ *        Inserting may move the entries, invalidating the pointers returned earlier.
+ */
+template<typename K, typename V, typename H = std::hash<K>>
+class FlatHashMap
+{
+public:
+    FlatHashMap() : _size(0), _shift(0) {}
+
+    std::size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    std::size_t capacity() const { return _slots.size(); }
+
+    V *find(const K& key)
+    {
+        const std::size_t i = locate(key);
+        return (i != npos) ? &_slots[i].value : nullptr;
+    }
+
+    const V *find(const K& key) const
+    {
+        const std::size_t i = locate(key);
+        return (i != npos) ? &_slots[i].value : nullptr;
+    }
+
+    /*!
+     * \brief Finds the key's value, inserting a default constructed one if there is none.
+     * \return - the value and whether it has been inserted
+     */
+    std::pair<V *, bool> insert(const K& key);
+
+    /*!< Erases the key's entry. Returns whether there was one. */
+    bool erase(const K& key);
+
+    /*!< Erases all the entries, keeping the capacity. */
+    void clear();
+
+    /*!< Calls f(key, value) for every entry in no particular order. */
+    template<typename F>
+    void forEach(F f) const
+    {
+        for (std::size_t i = 0; i < _slots.size(); ++i)
+        {
+            if (_used[i])
+                f(_slots[i].key, _slots[i].value);
+        }
+    }
+
+private:
+    struct Slot
+    {
+        K key;
+        V value;
+    };
+
+    static const std::size_t npos = std::size_t(-1);
+
+    /*!< The preferred slot. Fibonacci hashing spreads poor hashes, e.g. the identity for integers. */
+    std::size_t home(const K& key) const
+    {
+        return std::size_t((std::uint64_t(_hash(key)) * 0x9E3779B97F4A7C15ull) >> _shift);
+    }
+
+    std::size_t locate(const K& key) const;
+
+    /*!< Doubles the capacity, keeping the load factor under 3/4. */
+    void grow();
+
+    std::vector<Slot> _slots;
+    std::vector<unsigned char> _used;
+    std::size_t _size;
+    unsigned _shift;
+    H _hash;
+};
+
+template<typename K, typename V, typename H>
+std::size_t FlatHashMap<K, V, H>::locate(const K& key) const
+{
+    if (_size == 0)
+        return npos;
+
+    const std::size_t mask = _slots.size() - 1;
+    for (std::size_t i = home(key); _used[i]; i = (i + 1) & mask)
+    {
+        if (_slots[i].key == key)
+            return i;
+    }
+
+    return npos;
+}
+
+template<typename K, typename V, typename H>
+std::pair<V *, bool> FlatHashMap<K, V, H>::insert(const K& key)
+{
+    if (4 * (_size + 1) > 3 * _slots.size())
+        grow();
+
+    const std::size_t mask = _slots.size() - 1;
+    std::size_t i = home(key);
+    for (; _used[i]; i = (i + 1) & mask)
+    {
+        if (_slots[i].key == key)
+            return std::make_pair(&_slots[i].value, false);
+    }
+
+    _used[i] = 1;
+    _slots[i].key = key;
+    ++_size;
+    return std::make_pair(&_slots[i].value, true);
+}
+
+template<typename K, typename V, typename H>
+bool FlatHashMap<K, V, H>::erase(const K& key)
+{
+    std::size_t i = locate(key);
+    if (i == npos)
+        return false;
+
+    // Shift back the entries of the probe sequence that would not be found past the hole.
+    const std::size_t mask = _slots.size() - 1;
+    for (std::size_t j = (i + 1) & mask; _used[j]; j = (j + 1) & mask)
+    {
+        const std::size_t k = home(_slots[j].key);
+        const bool stays = (i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j));
+        if (stays)
+            continue;
+
+        _slots[i] = std::move(_slots[j]);
+        i = j;
+    }
+
+    _used[i] = 0;
+    _slots[i] = Slot();
+    --_size;
+    return true;
+}
+
+template<typename K, typename V, typename H>
+void FlatHashMap<K, V, H>::clear()
+{
+    for (std::size_t i = 0; i < _slots.size(); ++i)
+    {
+        if (_used[i])
+        {
+            _used[i] = 0;
+            _slots[i] = Slot();
+        }
+    }
+
+    _size = 0;
+}
+
+template<typename K, typename V, typename H>
+void FlatHashMap<K, V, H>::grow()
+{
+    std::vector<Slot> slots(_slots.empty() ? 8 : 2 * _slots.size());
+    std::vector<unsigned char> used(slots.size(), 0);
+    slots.swap(_slots);
+    used.swap(_used);
+
+    unsigned bits = 0;
+    while ((std::size_t(1) << bits) < _slots.size())
+        ++bits;
+
+    _shift = 64 - bits;
+
+    const std::size_t mask = _slots.size() - 1;
+    for (std::size_t i = 0; i < slots.size(); ++i)
+    {
+        if (!used[i])
+            continue;
+
+        std::size_t j = home(slots[i].key);
+        while (_used[j])
+            j = (j + 1) & mask;
+
+        _used[j] = 1;
+        _slots[j] = std::move(slots[i]);
+    }
+}
+
+#endif // FLATHASHMAP_H
@@ -0,0 +1,189 @@
+#ifndef INLINEFUNCTION_H
+#define INLINEFUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template<typename Signature, std::size_t Capacity = 6 * sizeof(void *)>
+class InlineFunction;
+
+/*!
+ * \brief A move-only callable wrapper with a fixed inline buffer.
+ *        Unlike std::function, a functor that fits into the buffer
+ *        (and is nothrow move constructible) never touches the heap.
+ *        Larger functors are still accepted, but are stored on the heap.
+ */
+template<typename R, typename... Args, std::size_t Capacity>
+class InlineFunction<R (Args...), Capacity>
+{
+public:
+    InlineFunction() : _ops(nullptr) {}
+    InlineFunction(std::nullptr_t) : _ops(nullptr) {}
+
+    template<typename F,
+             typename = typename std::enable_if<
+                 !std::is_same<typename std::decay<F>::type, InlineFunction>::value>::type>
+    InlineFunction(F&& f) : _ops(nullptr)
+    {
+        emplace<typename std::decay<F>::type>(std::forward<F>(f));
+    }
+
+    InlineFunction(InlineFunction&& other) : _ops(nullptr)
+    {
+        moveFrom(other);
+    }
+
+    InlineFunction& operator=(InlineFunction&& other)
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+
+        return *this;
+    }
+
+    InlineFunction& operator=(std::nullptr_t)
+    {
+        reset();
+        return *this;
+    }
+
+    InlineFunction(const InlineFunction&) = delete;
+    InlineFunction& operator=(const InlineFunction&) = delete;
+
+    ~InlineFunction() { reset(); }
+
+    explicit operator bool() const { return _ops != nullptr; }
+
+    R operator()(Args... args) const
+    {
+        return _ops->invoke(storage(), std::forward<Args>(args)...);
+    }
+
+    /*!< Destroys the stored functor, if any. */
+    void reset()
+    {
+        if (_ops)
+        {
+            _ops->destroy(storage());
+            _ops = nullptr;
+        }
+    }
+
+    /*!< The heap memory taken by a stored functor that did not fit into the buffer, otherwise 0. */
+    std::size_t heapBytes() const { return _ops ? _ops->heapBytes : 0; }
+
+    /*!< Whether a functor of type F is stored in the inline buffer. */
+    template<typename F>
+    static constexpr bool storedInline()
+    {
+        return (sizeof(F) <= Capacity)
+                && (alignof(F) <= alignof(Storage))
+                && std::is_nothrow_move_constructible<F>::value;
+    }
+
+private:
+    using Storage = typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type;
+
+    struct Ops
+    {
+        R (*invoke)(void *, Args&&...);
+        void (*move)(void *from, void *to);
+        void (*destroy)(void *);
+        std::size_t heapBytes;
+    };
+
+    template<typename F>
+    struct InlineOps
+    {
+        static R invoke(void *p, Args&&... args)
+        {
+            return (*static_cast<F *>(p))(std::forward<Args>(args)...);
+        }
+
+        static void move(void *from, void *to)
+        {
+            new (to) F(std::move(*static_cast<F *>(from)));
+            static_cast<F *>(from)->~F();
+        }
+
+        static void destroy(void *p)
+        {
+            static_cast<F *>(p)->~F();
+        }
+
+        static const Ops ops;
+    };
+
+    template<typename F>
+    struct HeapOps
+    {
+        static F *&target(void *p) { return *static_cast<F **>(p); }
+
+        static R invoke(void *p, Args&&... args)
+        {
+            return (*target(p))(std::forward<Args>(args)...);
+        }
+
+        static void move(void *from, void *to)
+        {
+            new (to) F *(target(from));
+        }
+
+        static void destroy(void *p)
+        {
+            delete target(p);
+        }
+
+        static const Ops ops;
+    };
+
+    template<typename F, typename A>
+    typename std::enable_if<storedInline<F>()>::type emplace(A&& f)
+    {
+        new (storage()) F(std::forward<A>(f));
+        _ops = &InlineOps<F>::ops;
+    }
+
+    template<typename F, typename A>
+    typename std::enable_if<!storedInline<F>()>::type emplace(A&& f)
+    {
+        new (storage()) F *(new F(std::forward<A>(f)));
+        _ops = &HeapOps<F>::ops;
+    }
+
+    void moveFrom(InlineFunction& other)
+    {
+        if (other._ops)
+        {
+            other._ops->move(other.storage(), storage());
+            _ops = other._ops;
+            other._ops = nullptr;
+        }
+    }
+
+    void *storage() const { return const_cast<Storage *>(&_storage); }
+
+    Storage _storage;
+    const Ops *_ops;
+};
+
+template<typename R, typename... Args, std::size_t Capacity>
+template<typename F>
+const typename InlineFunction<R (Args...), Capacity>::Ops
+InlineFunction<R (Args...), Capacity>::InlineOps<F>::ops = {
+    &InlineOps<F>::invoke, &InlineOps<F>::move, &InlineOps<F>::destroy, 0
+};
+
+template<typename R, typename... Args, std::size_t Capacity>
+template<typename F>
+const typename InlineFunction<R (Args...), Capacity>::Ops
+InlineFunction<R (Args...), Capacity>::HeapOps<F>::ops = {
+    &HeapOps<F>::invoke, &HeapOps<F>::move, &HeapOps<F>::destroy, sizeof(F)
+};
+
+#endif // INLINEFUNCTION_H
@@ -0,0 +1,233 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+/*!
+ * Optional observable instrumentation.
+ * Define OBSERVABLE_INSTRUMENTATION for the whole program to enable it,
+ * otherwise the hooks compile to nothing and observables carry no extra state.
+ */
+#ifdef OBSERVABLE_INSTRUMENTATION
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define OBSERVABLE_INSTRUMENT(statement) statement
+
+/*!
+ * \brief A histogram of durations with power of two buckets:
+ *        bucket i counts the durations in [2^i, 2^(i+1)) nanoseconds.
+ */
+struct LatencyHistogram
+{
+    static const int bucketCount = 40;
+
+    std::uint64_t buckets[bucketCount] = {};
+    std::uint64_t count = 0;
+    std::uint64_t totalNs = 0;
+    std::uint64_t maxNs = 0;
+
+    void record(std::uint64_t ns)
+    {
+        int bucket = 0;
+        while ((bucket < bucketCount - 1) && (ns >> (bucket + 1)))
+            ++bucket;
+
+        ++buckets[bucket];
+        ++count;
+        totalNs += ns;
+        if (ns > maxNs)
+            maxNs = ns;
+    }
+};
+
+/*!
+ * \brief Counters of a single observable.
+ *        Registers itself in the global registry for its lifetime.
+ *        Updated by the observable's own thread only.
+ */
+class ObservableStats
+{
+public:
+    ObservableStats();
+    ObservableStats(const ObservableStats& other);
+    ObservableStats& operator=(const ObservableStats& other) = delete;
+    ~ObservableStats();
+
+    std::string name;
+
+    std::uint64_t sets = 0;            /*!< set() calls */
+    std::uint64_t unchangedSets = 0;   /*!< set() calls filtered out by the comparison */
+    std::uint64_t notifications = 0;   /*!< change notifications */
+    std::uint64_t prunes = 0;          /*!< dead callbacks erased */
+    std::size_t subscribers = 0;       /*!< callback list size */
+
+    LatencyHistogram callbackLatency;  /*!< all the callbacks together */
+
+    /*!
+     * \brief Per-callback latency, keyed by the subscription.
+     *        The elements never move, so a callback keeps a pointer to its histogram.
+     */
+    std::unordered_map<const void *, LatencyHistogram> perCallback;
+
+    using Clock = std::chrono::steady_clock;
+
+    LatencyHistogram *callbackHistogram(const void *callback) { return &perCallback[callback]; }
+
+    /*!
+     * \brief Records a callback that ran from start till now.
+     *        Returns now, so that consecutive callbacks need a single clock reading each.
+     */
+    Clock::time_point recordCallback(LatencyHistogram *histogram, Clock::time_point start)
+    {
+        Clock::time_point end = Clock::now();
+        std::uint64_t ns = std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    end - start).count());
+        callbackLatency.record(ns);
+        histogram->record(ns);
+        return end;
+    }
+
+    void forgetCallback(const void *callback) { perCallback.erase(callback); }
+};
+
+/*!
+ * \brief The registry of live observable counters.
+ *        Dumping is meant to be done from the thread that owns the observables.
+ */
+class Instrumentation
+{
+public:
+    /*!< Human readable report. */
+    static void dump(std::ostream& out)
+    {
+        std::lock_guard<std::mutex> lock(mutex());
+        for (const ObservableStats *s : registry())
+        {
+            out << (s->name.empty() ? std::string("<unnamed>") : s->name)
+                << ": sets " << s->sets
+                << ", unchanged " << s->unchangedSets
+                << ", notifications " << s->notifications
+                << ", subscribers " << s->subscribers
+                << ", prunes " << s->prunes
+                << ", callback ns avg " << average(s->callbackLatency)
+                << " max " << s->callbackLatency.maxNs << "\n";
+        }
+    }
+
+    /*!< Machine readable report, including the latency histograms. */
+    static void dumpJson(std::ostream& out)
+    {
+        std::lock_guard<std::mutex> lock(mutex());
+        out << "{\"observables\": [";
+        bool first = true;
+        for (const ObservableStats *s : registry())
+        {
+            out << (first ? "\n" : ",\n") << "  {\"name\": \"" << s->name << "\""
+                << ", \"sets\": " << s->sets
+                << ", \"unchangedSets\": " << s->unchangedSets
+                << ", \"notifications\": " << s->notifications
+                << ", \"subscribers\": " << s->subscribers
+                << ", \"prunes\": " << s->prunes
+                << ", \"callbackLatency\": ";
+            writeHistogram(out, s->callbackLatency);
+            out << ", \"perCallback\": [";
+            bool firstCallback = true;
+            for (const auto& c : s->perCallback)
+            {
+                out << (firstCallback ? "" : ", ");
+                writeHistogram(out, c.second);
+                firstCallback = false;
+            }
+
+            out << "]}";
+            first = false;
+        }
+
+        out << "\n]}\n";
+    }
+
+    /*!< Zeroes all the counters. */
+    static void reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex());
+        for (ObservableStats *s : registry())
+        {
+            s->sets = s->unchangedSets = s->notifications = s->prunes = 0;
+            s->callbackLatency = LatencyHistogram();
+            for (auto& c : s->perCallback)
+                c.second = LatencyHistogram();
+        }
+    }
+
+private:
+    friend class ObservableStats;
+
+    static std::mutex& mutex()
+    {
+        static std::mutex m;
+        return m;
+    }
+
+    static std::vector<ObservableStats *>& registry()
+    {
+        static std::vector<ObservableStats *> r;
+        return r;
+    }
+
+    static double average(const LatencyHistogram& h)
+    {
+        return h.count ? double(h.totalNs) / h.count : 0.0;
+    }
+
+    static void writeHistogram(std::ostream& out, const LatencyHistogram& h)
+    {
+        out << "{\"count\": " << h.count << ", \"avgNs\": " << average(h)
+            << ", \"maxNs\": " << h.maxNs << ", \"log2Buckets\": [";
+        int last = LatencyHistogram::bucketCount - 1;
+        while ((last > 0) && !h.buckets[last])
+            --last;
+
+        for (int i = 0; i <= last; ++i)
+            out << (i ? ", " : "") << h.buckets[i];
+
+        out << "]}";
+    }
+};
+
+inline ObservableStats::ObservableStats()
+{
+    std::lock_guard<std::mutex> lock(Instrumentation::mutex());
+    Instrumentation::registry().push_back(this);
+}
+
+inline ObservableStats::ObservableStats(const ObservableStats& other) : ObservableStats()
+{
+    name = other.name;
+}
+
+inline ObservableStats::~ObservableStats()
+{
+    std::lock_guard<std::mutex> lock(Instrumentation::mutex());
+    std::vector<ObservableStats *>& r = Instrumentation::registry();
+    for (std::size_t i = 0; i < r.size(); ++i)
+    {
+        if (r[i] == this)
+        {
+            r.erase(r.begin() + i);
+            break;
+        }
+    }
+}
+
+#else
+
+#define OBSERVABLE_INSTRUMENT(statement)
+
+#endif // OBSERVABLE_INSTRUMENTATION
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,306 @@
+#ifndef NOTIFICATIONSCHEDULER_H
+#define NOTIFICATIONSCHEDULER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "flathashmap.h"
+#include "propagation.h"
+
+/*!
+ * \brief Named callback priorities. The callbacks of a higher priority are dispatched first.
+ */
+struct NotificationPriority
+{
+    enum : int
+    {
+        Repaint = -100, /*!< UI updates, e.g. resizing or repainting a widget. */
+        Default = 0,
+        Model = 100     /*!< Derived model state, e.g. a cache or an index. */
+    };
+};
+
+/*!
+ * \brief Something whose callbacks may be dispatched by a NotificationScheduler.
+ *        Implemented by Observable.
+ */
+class SchedulerParticipant
+{
+public:
+    /*!< Runs the callbacks of the given priority with the current value. */
+    virtual void dispatch(int priority) = 0;
+
+protected:
+    ~SchedulerParticipant() {}
+};
+
+/*!
+ * \brief An optional queue for the observable callbacks of a thread.
+ *
+ *        By default the callbacks run inside set(), in subscription order,
+ *        and a callback setting another observable recurses into its callbacks.
+ *        While a scheduler is installed, a change only queues the observable,
+ *        once per priority of its callbacks, and run() dispatches the queue:
+ *        higher priorities first, then in the order of the changes.
+ *        Nested changes are queued as well, so the stack depth stays the same
+ *        however long the chain of updates is.
+ *
+ *        A queued observable is dispatched once, with its value at the time,
+ *        however many times it has changed meanwhile.
+ *        Callbacks still fire synchronously upon adding.
+ *
+ *        The scheduler keeps track of where each queued change came from,
+ *        so that bindings behave as without it: a dispatched change is never converted back
+ *        into the observables it came from, and does not overwrite an observable
+ *        changed later than the change the dispatch started from. Cyclic bindings settle,
+ *        and of two changes made before run() the latest wins.
+ *
+ *        run() is either called manually, e.g. by tests, or by the wakeup function,
+ *        called whenever the queue stops being empty, see driveFromEventLoop().
+ */
+class NotificationScheduler
+{
+public:
+    NotificationScheduler() : _sequence(0), _running(false), _origins(0), _origin(0), _dispatching(noTrace) {}
+
+    ~NotificationScheduler() { uninstall(); }
+
+    NotificationScheduler(const NotificationScheduler&) = delete;
+    NotificationScheduler& operator=(const NotificationScheduler&) = delete;
+
+    /*!< The scheduler installed on the current thread, or nullptr. */
+    static NotificationScheduler *current() { return currentSlot(); }
+
+    /*!< Makes this the scheduler of the current thread, replacing the installed one, if any. */
+    void install()
+    {
+        if (NotificationScheduler *installed = current())
+            installed->uninstall();
+
+        currentSlot() = this;
+    }
+
+    /*!< Dispatches what is still queued and restores synchronous notifications. */
+    void uninstall()
+    {
+        if (current() != this)
+            return;
+
+        run();
+        currentSlot() = nullptr;
+    }
+
+    /*!< Called on the first change queued after the queue has been empty. */
+    void setWakeup(std::function<void ()> wakeup) { _wakeup = std::move(wakeup); }
+
+    bool empty() const { return _queue.empty(); }
+    std::size_t size() const { return _queue.size(); }
+
+    /*!< Dispatches the queue until it is empty. Does nothing if called from a callback. */
+    void run();
+
+    /*!< Queues a participant's callbacks of a priority. Does nothing if they are queued already. */
+    void enqueue(SchedulerParticipant *participant, int priority);
+
+    /*!
+     * \brief Records a change of a participant, after its callbacks are queued.
+     *        A change made while a participant is being dispatched continues that update,
+     *        any other change starts an update of its own.
+     */
+    void changed(const SchedulerParticipant *participant);
+
+    /*!
+     * \brief Whether the change being dispatched must not be written into the target:
+     *        the change came from the target, or the target has changed later.
+     */
+    bool reached(const SchedulerParticipant *target) const;
+
+    /*!< Drops the queued dispatches of a participant, e.g. when it is destroyed. */
+    void forget(SchedulerParticipant *participant)
+    {
+        for (Entry& e : _queue)
+        {
+            if (e.participant == participant)
+            {
+                _queued.erase(Key { participant, e.priority });
+                e.participant = nullptr;
+            }
+        }
+
+        // The address may be reused by another participant within the same run.
+        _changes.erase(participant);
+        for (Trace& t : _traces)
+        {
+            if (t.participant == participant)
+                t.participant = nullptr;
+        }
+    }
+
+private:
+    struct Entry
+    {
+        int priority;
+        std::uint64_t order;
+        SchedulerParticipant *participant;
+
+        // std::push_heap builds a max-heap: the highest priority, then the earliest change, first.
+        bool operator<(const Entry& other) const
+        {
+            return (priority != other.priority) ? (priority < other.priority) : (order > other.order);
+        }
+    };
+
+    struct Key
+    {
+        SchedulerParticipant *participant;
+        int priority;
+
+        bool operator==(const Key& other) const
+        {
+            return (participant == other.participant) && (priority == other.priority);
+        }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const
+        {
+            return std::hash<const void *>()(key.participant) ^ std::hash<int>()(key.priority);
+        }
+    };
+
+    static const std::size_t noTrace = std::size_t(-1);
+
+    /*!< A dispatched participant, linked to the dispatch whose change made it queued. */
+    struct Trace
+    {
+        const SchedulerParticipant *participant;
+        std::size_t parent;
+    };
+
+    /*!
+     * \brief The last change of a participant: its update, and the dispatch it was made by.
+     *        dispatched tells whether the participant has been dispatched during the run,
+     *        i.e. whether it may be found in the traces at all.
+     */
+    struct Change
+    {
+        std::uint64_t origin = 0;
+        std::size_t trace = noTrace;
+        bool dispatched = false;
+    };
+
+    static NotificationScheduler *&currentSlot()
+    {
+        static thread_local NotificationScheduler *scheduler = nullptr;
+        return scheduler;
+    }
+
+    std::vector<Entry> _queue;
+    FlatHashMap<Key, bool, KeyHash> _queued;
+    std::uint64_t _sequence;
+    bool _running;
+    std::function<void ()> _wakeup;
+
+    // The bookkeeping of the changes pending or dispatched, dropped once the queue is empty.
+    FlatHashMap<const SchedulerParticipant *, Change> _changes;
+    std::vector<Trace> _traces;
+    std::uint64_t _origins;
+    std::uint64_t _origin;       /*!< the update of the running dispatch */
+    std::size_t _dispatching;    /*!< the trace of the running dispatch, or noTrace */
+};
+
+inline void NotificationScheduler::changed(const SchedulerParticipant *participant)
+{
+    // With nothing queued, no dispatch may overwrite the change.
+    if (_queue.empty() && !_running)
+        return;
+
+    const bool nested = (_dispatching != noTrace);
+    Change& change = *_changes.insert(participant).first;
+    change.origin = nested ? _origin : ++_origins;
+    change.trace = _dispatching;
+}
+
+inline bool NotificationScheduler::reached(const SchedulerParticipant *target) const
+{
+    if (_dispatching == noTrace)
+        return false;
+
+    const Change *change = _changes.find(target);
+    if (!change)
+        return false;
+
+    if (change->origin > _origin)
+        return true;
+
+    if (!change->dispatched)
+        return false;
+
+    for (std::size_t t = _dispatching; t != noTrace; t = _traces[t].parent)
+    {
+        if (_traces[t].participant == target)
+            return true;
+    }
+
+    return false;
+}
+
+inline void NotificationScheduler::enqueue(SchedulerParticipant *participant, int priority)
+{
+    std::pair<bool *, bool> queued = _queued.insert(Key { participant, priority });
+    if (!queued.second)
+        return;
+
+    const bool wake = _queue.empty() && !_running;
+    _queue.push_back(Entry { priority, _sequence++, participant });
+    std::push_heap(_queue.begin(), _queue.end());
+
+    if (wake && _wakeup)
+        _wakeup();
+}
+
+inline void NotificationScheduler::run()
+{
+    if (_running)
+        return;
+
+    _running = true;
+    while (!_queue.empty())
+    {
+        // A single scope for the whole queue: derived values are propagated
+        // when it closes, and may queue more changes.
+        Propagation::Scope scope;
+        while (!_queue.empty())
+        {
+            std::pop_heap(_queue.begin(), _queue.end());
+            Entry e = _queue.back();
+            _queue.pop_back();
+
+            if (!e.participant)
+                continue;
+
+            _queued.erase(Key { e.participant, e.priority });
+
+            // Queued participants normally have their change recorded already, see changed().
+            std::pair<Change *, bool> change = _changes.insert(e.participant);
+            if (change.second)
+                change.first->origin = ++_origins;
+
+            change.first->dispatched = true;
+            _origin = change.first->origin;
+            _traces.push_back(Trace { e.participant, change.first->trace });
+            _dispatching = _traces.size() - 1;
+            e.participant->dispatch(e.priority);
+            _dispatching = noTrace;
+        }
+    }
+
+    _changes.clear();
+    _traces.clear();
+    _running = false;
+}
+
+#endif // NOTIFICATIONSCHEDULER_H
@@ -1,17 +1,78 @@
 #ifndef OBSERVABLE_H
 #define OBSERVABLE_H
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
-#include <deque>
-#include <algorithm>
-#include <unordered_set>
+#include <utility>
+#include "inlinefunction.h"
+#include "instrumentation.h"
+#include "notificationscheduler.h"
+#include "observablearena.h"
+#include "observablebatch.h"
+#include "propagation.h"
+#include "slotmap.h"
+#include "subscription.h"
+
+/*!
+ * \brief A handle to a binding kept in an observable's binding list.
+ */
+struct BindingRef
+{
+    SlotKey slot;
+    WeakSubscription binding;
+
+    BindingRef() {}
+    BindingRef(SlotKey s, const Subscription& b) : slot(s), binding(b) {}
+
+    bool expired() const { return binding.expired(); }
+};
+
+/*!
+ * \brief The memory taken by an observable's callback and binding lists, see Observable::memory().
+ */
+struct ObservableMemory
+{
+    std::size_t callbacks = 0;      /*!< live callbacks */
+    std::size_t deadCallbacks = 0;  /*!< callbacks gone, but still listed until swept */
+    std::size_t bindings = 0;       /*!< live bindings */
+    std::size_t deadBindings = 0;   /*!< bindings to destroyed observables, still listed until swept */
+
+    /*!< The callback list and the nodes of the listed callbacks, the inline captures included. */
+    std::size_t callbackBytes = 0;
+
+    /*!
+     * \brief The binding list and the nodes of the dead bindings.
+     *        The nodes of the live ones belong to the callback lists of the observables bound to.
+     */
+    std::size_t bindingBytes = 0;
+
+    /*!< The captures of the listed callbacks that did not fit inline. */
+    std::size_t captureBytes = 0;
+
+    std::size_t totalBytes() const { return callbackBytes + bindingBytes + captureBytes; }
+};
+
+/*!
+ * \brief How an observable decides whether a new value differs from the current one.
+ */
+enum class Comparison
+{
+    Equal,  /*!< Compare the values with operator!=, the default. */
+    Always, /*!< Do not compare, every set() is a change. */
+    Hash,   /*!< Compare the hash of the new value with the hash of the current one. */
+    Custom  /*!< Compare with a user supplied functor, e.g. by identity of shared data. */
+};
 
 /*!
  * \brief An abstract typed bindable observable value.
- *        The value type must be assignable and comparable.
+ *        The value type must be assignable,
+ *        and comparable unless another comparison policy is set up.
+ *        An observable constructed within an ObservableArena::Scope
+ *        keeps its callbacks and bindings in that arena.
  */
-template<typename T> class Observable
+template<typename T> class Observable : private BatchParticipant, private SchedulerParticipant
 {
 public:
     /*!
@@ -20,20 +81,135 @@ public:
      *        whether the observable executes a callback immediately upon adding.
      */
     Observable(bool firesOnAddCallback = true)
-        : _callbacks(), _fireOnAdd(firesOnAddCallback), _bindings() {}
+        : _callbacks(ObservableArena::current()), _fireOnAdd(firesOnAddCallback),
+          _bindings(ObservableArena::current()), _notifying(0), _batched(false), _stamp(0),
+          _version(0), _arena(ObservableArena::current()), _scheduled(false),
+          _callbacksSwept(0), _bindingsSwept(0)
+    {
+        ObservableArena::retain(_arena);
+    }
+
+    virtual ~Observable()
+    {
+        if (_batched)
+            ObservableBatch::forget(this);
+
+        if (_scheduled)
+        {
+            if (NotificationScheduler *scheduler = NotificationScheduler::current())
+                scheduler->forget(this);
+        }
+
+        // The bindings other observables keep to this one's callbacks are dead from now on.
+        for (std::size_t i = 0; i < _callbacks.slotCount(); ++i)
+        {
+            StoredCallbackPtr *stored = _callbacks.at(i);
+            if (stored && !stored->expired())
+                stored->node()->detach();
+        }
+
+        // The containers hold references of their own, so the arena survives until they are gone.
+        ObservableArena::release(_arena);
+    }
 
     /*!< firesOnAddCallback property accessors. */
     bool firesOnAddCallback() const { return _fireOnAdd; }
     void setFiresOnAddCallback(bool flag) { _fireOnAdd = flag; }
 
+    /*!
+     * \brief Names the observable in the instrumentation reports.
+     *        Does nothing unless OBSERVABLE_INSTRUMENTATION is defined.
+     */
+    void setName(const char *name)
+    {
+        OBSERVABLE_INSTRUMENT(_stats.name = name;)
+        (void)name;
+    }
+
     /*!< Get the observable's value. */
     virtual T get() = 0;
 
-    /*!< Set a new value. After assignment, the observer fires its callbacks. */
+    /*!
+     * \brief A counter incremented whenever the value changes.
+     *        It may also be incremented when the value happens to stay the same,
+     *        but an unchanged version guarantees an unchanged value,
+     *        so consumers can skip work with a version check instead of comparing values.
+     */
+    std::uint64_t version() const { return _version; }
+
+    /*!< The comparison policy set() uses to drop unchanged values. */
+    Comparison comparison() const { return _comparator ? _comparator->policy : Comparison::Equal; }
+
+    /*!< Compare the values with operator!=, the default policy. */
+    void compareByValue() { _comparator.reset(); }
+
+    /*!
+     * \brief Treat every set() as a change.
+     *        Saves the comparison, and with no stored value the get() call,
+     *        e.g. a widget getter, at the cost of notifying of unchanged values.
+     */
+    void compareAlways() { comparator().policy = Comparison::Always; }
+
+    /*!
+     * \brief Compare hashes instead of values.
+     *        The hash of the current value is cached, so a set() hashes the new value only.
+     *        Values with colliding hashes are taken for equal, so use a strong hash.
+     */
+    template<typename H = std::hash<T>>
+    void compareByHash(H hash = H())
+    {
+        Comparator& c = comparator();
+        c.policy = Comparison::Hash;
+        c.hash = std::move(hash);
+        c.hashed = false;
+    }
+
+    /*!
+     * \brief Compare the values with a functor returning true for equal values,
+     *        e.g. one comparing the shared data pointers of implicitly shared values.
+     */
+    template<typename C>
+    void compareWith(C same)
+    {
+        Comparator& c = comparator();
+        c.policy = Comparison::Custom;
+        c.same = std::move(same);
+    }
+
+    /*!
+     * \brief Whether the running update has come through the observable,
+     *        i.e. it is being set or its callbacks are running.
+     *        Bindings leave such observables alone, so that an update
+     *        is never converted back into the observables it came from,
+     *        while an observable reached along several paths takes the write of each.
+     *        With a NotificationScheduler, the same holds for the queued changes.
+     */
+    bool visited() const
+    {
+        if ((_notifying > 0) && Propagation::current(_stamp))
+            return true;
+
+        NotificationScheduler *scheduler = NotificationScheduler::current();
+        return scheduler && scheduler->reached(this);
+    }
+
+    /*!
+     * \brief Set a new value. After assignment, the observer fires its callbacks,
+     *        unless an ObservableBatch defers them.
+     *        The value is taken by value and moved into the storage,
+     *        so pass an rvalue to avoid copying large values altogether.
+     */
     virtual void set(T value);
 
-    using Callback = std::function<void (T newV)>;
-    using CallbackPtr = std::shared_ptr<Callback>;
+    /*!
+     * \brief A callback receives a reference to the new value.
+     *        The reference is only valid during the call
+     *        and reflects nested updates made by the callback itself,
+     *        copy the value if it is needed later.
+     *        Callbacks whose captures fit into the inline buffer do not allocate.
+     */
+    using Callback = InlineFunction<void (const T& newV)>;
+    using CallbackPtr = Subscription;
 
     /*!
      * \brief Add a callback to be executed after a new value was set.
@@ -42,37 +218,62 @@ public:
      *        The observable keeps a weak reference to the callback only,
      *        so the callback is automatically destroyed,
      *        when the last copy of the control handle is destroyed.
+     *        Its entry is erased by the next notification,
+     *        or by the next sweep of the list, which adding a callback makes once in a while.
      *        Store the control handle as e.g. a class member
      *        to keep receiving notifications from the observable.
+     *        The priority orders the callbacks dispatched by a NotificationScheduler,
+     *        without one the callbacks run in subscription order.
      */
     template<typename F>
-    CallbackPtr addCallback(F block)
+    CallbackPtr addCallback(F block, int priority = NotificationPriority::Default)
     {
-        CallbackPtr onUpdate(new Callback(block));
-        _callbacks.emplace_back(onUpdate);
+        void *memory = ObservableArena::allocate(_arena, sizeof(CallbackNode));
+        CallbackNode *node = new (memory) CallbackNode(std::move(block), _arena, priority);
+        CallbackPtr onUpdate(node);
+
+        if ((_notifying == 0) && sweepDue(_callbacks, _callbacksSwept))
+            sweepCallbacks();
+
+        // Slots are not reused during a notification,
+        // so that a new callback is never invoked for a change made before it was added.
+        node->slot = (_notifying > 0) ? _callbacks.append(onUpdate) : _callbacks.insert(onUpdate);
+        OBSERVABLE_INSTRUMENT(_stats.subscribers = _callbacks.size();)
+        OBSERVABLE_INSTRUMENT(node->latency = _stats.callbackHistogram(node);)
 
         if (_fireOnAdd)
         {
-            T value = get();
-            onUpdate->operator()(value);
+            if (const T *current = stored())
+            {
+                node->callback(*current);
+            }
+            else
+            {
+                T value = get();
+                node->callback(value);
+            }
         }
 
         return onUpdate;
     }
 
     /*!
-     * \brief Removes a callback from the observable's list.
+     * \brief Removes a callback from the observable's list in O(1).
      *        Does nothing if the callback does not belong to the list.
      */
-    void removeCallback(CallbackPtr callback);
+    void removeCallback(const CallbackPtr& callback);
+
+    /*!< Whether any callback is still alive. */
+    bool hasCallbacks();
 
-    using Binding = std::shared_ptr<void>;
-    using BindingHandle = std::weak_ptr<void>;
+    using Binding = Subscription;
+    using BindingHandle = BindingRef;
 
     /*!
      * \brief Binds the observable to another one,
      *        so that the callee's value becomes synchronized with the other one's.
      *        If the callee is already bound to some observable, that binding is replaced.
+     *        An update that has already changed the callee is not written back into it.
      *
      * \param other - the observable to bind to.
      * \param convert - a functor that transforms other observable's value to the callee's type.
@@ -83,13 +284,16 @@ public:
     BindingHandle bind(Observable<O>& other, C convert)
     {
         Binding binding = other.addCallback(
-                    [this, convert](O value)
+                    [this, convert](const O& value)
                     {
-                          this->set(convert(value));
+                        if (this->visited())
+                            return;
+
+                        Propagation::countConversion();
+                        this->set(convert(value));
                     });
 
-        _bindings.insert(binding);
-        return binding;
+        return addBinding(binding);
     }
 
     /*!
@@ -106,25 +310,30 @@ public:
      */
     BindingHandle addBinding(Binding binding)
     {
-        _bindings.insert(binding);
-        return binding;
+        if (sweepDue(_bindings, _bindingsSwept))
+            sweepBindings();
+
+        SlotKey slot = _bindings.insert(binding);
+        return BindingHandle(slot, binding);
     }
 
     /*!
-     * \brief Removes a binding by its handle.
+     * \brief Removes a binding by its handle in O(1).
      *        If the binding is not present in the list,
      *        or the handle has expired, does nothing.
      */
-    void removeBinding(BindingHandle h)
+    void removeBinding(const BindingHandle& h)
     {
-        Binding b = h.lock();
-        if (b && (_bindings.find(b) != _bindings.end()))
-            _bindings.erase(b);
+        Binding *b = _bindings.find(h.slot);
+        if (b && !h.expired() && (b->node() == h.binding.node()))
+            _bindings.erase(h.slot);
     }
 
     /*!
      * \brief Create a two way binding between observables,
      *        so that the values become synchronized.
+     *        Bindings may form arbitrary graphs, including cycles:
+     *        an update is never converted back into the observables it came from.
      * \param other - another observable to bind to.
      * \param convert -  a functor that will be used to convert
      *                   the other observable's value to the callee's value type.
@@ -136,35 +345,27 @@ public:
     template<typename O, typename OT, typename TO>
     std::pair<BindingHandle, BindingHandle> bindTwoWay(Observable<O>& other, OT convert, TO revert)
     {
-        std::shared_ptr<bool> lock(new bool(false));
-
         Binding b1 = other.addCallback(
-                    [this, convert, lock](O value)
+                    [this, convert](const O& value)
                     {
-                        if (*lock)
+                        if (this->visited())
                             return;
-                        else
-                            *lock = true;
 
+                        Propagation::countConversion();
                         this->set(convert(value));
-
-                        *lock = false;
                     });
 
         BindingHandle h1 = addBinding(b1);
 
         Observable<O> *pOther = &other;
         CallbackPtr observeThis = addCallback(
-                    [pOther, revert, lock](T value)
+                    [pOther, revert](const T& value)
                     {
-                        if (*lock)
+                        if (pOther->visited())
                             return;
-                        else
-                            *lock = true;
 
+                        Propagation::countConversion();
                         pOther->set(revert(value));
-
-                        *lock = false;
                     });
 
         BindingHandle h2 = other.addBinding(observeThis);
@@ -173,64 +374,525 @@ public:
 
     /*!< Overloaded binding method for the observable of the same type */
     std::pair<BindingHandle, BindingHandle> bindTwoWay(Observable<T>& other);
+
+    /*!
+     * \brief Erases the dead callbacks and the bindings to destroyed observables,
+     *        then releases the unused capacity of the lists.
+     *        Meant for long-lived observables that rarely change, e.g. once a session gets idle.
+     *        Called from one of the observable's callbacks, only erases.
+     */
+    void compact();
+
+    /*!
+     * \brief Reports the memory taken by the callback and binding lists.
+     *        Walks the lists, so it is meant for periodic monitoring, not for hot paths.
+     */
+    ObservableMemory memory();
 protected:
     /*!< A bare value setter, that is, the one that does not notify the observers */
-    virtual void doSet(T& value) = 0;
+    virtual void doSet(T&& value) = 0;
+
+    /*!
+     * \brief Direct access to the stored value, if the subclass has one.
+     *        Lets set() and the notification path use the value in place
+     *        instead of copying it with get(). The default returns nullptr.
+     */
+    virtual const T *stored() { return nullptr; }
+
+    /*!
+     * \brief Notifies the observers of a value changed behind set(), e.g. by a widget,
+     *        by invoking the callbacks.
+     */
+    void onChange(const T& newValue);
+
+    /*!
+     * \brief Whether the value is the same as the current one according to the comparison policy.
+     *        current may be nullptr, then get() is called if the policy needs the current value.
+     *        A false result is taken for an accepted change.
+     */
+    bool unchanged(const T& value, const T *current);
+
+    /*!
+     * \brief Increments the version, for subclasses changing the value bypassing set().
+     *        Also drops the cached hash of the value, which is stale from now on.
+     */
+    void touch()
+    {
+        ++_version;
+        if (_comparator)
+            _comparator->hashed = false;
+    }
 
-    /*!< This method notifies observers when a new value was set by invoking the callbacks */
-    void onChange(T newValue);
+    /*!
+     * \brief Reports a change made in place, e.g. by a container mutation,
+     *        as if it was made by set(): the notification is deferred by a running batch.
+     */
+    void changed()
+    {
+        Propagation::Scope scope;
+        stamp();
+        ++_notifying;
+
+        // The value has changed in place, so the cached hash is stale.
+        touch();
+        publish();
+        --_notifying;
+    }
+
+    /*!
+     * \brief The body of set() for a subclass keeping the value in a member of its own.
+     *        Works on the storage directly instead of calling stored() and doSet(),
+     *        so that a final subclass sets its value without any virtual call.
+     */
+    void setStored(T& storage, T&& value);
 private:
-    using StoredCallbackPtr = std::weak_ptr<Callback>;
-    using Callbacks = std::deque<StoredCallbackPtr>;
+    /*!< A comparison policy other than the default one, allocated on demand. */
+    struct Comparator
+    {
+        Comparison policy = Comparison::Equal;
+        InlineFunction<bool (const T&, const T&)> same;
+        InlineFunction<std::size_t (const T&)> hash;
+        std::size_t lastHash = 0;
+        bool hashed = false;
+    };
+
+    Comparator& comparator()
+    {
+        if (!_comparator)
+            _comparator.reset(new Comparator());
+
+        return *_comparator;
+    }
+
+    /*!< A subscription node that owns the callback inline. */
+    struct CallbackNode : public SubscriptionNode
+    {
+        template<typename F>
+        CallbackNode(F&& block, ObservableArena *a, int p) : callback(std::forward<F>(block)), arena(a), priority(p) {}
+
+        Callback callback;
+        ObservableArena *arena;
+        int priority;
+        OBSERVABLE_INSTRUMENT(LatencyHistogram *latency = nullptr;)
+
+        std::size_t bytes() const { return sizeof(CallbackNode); }
+        std::size_t captureBytes() const { return callback.heapBytes(); }
+
+    protected:
+        void dispose() { callback = nullptr; }
+
+        void destroy()
+        {
+            ObservableArena *a = arena;
+            this->~CallbackNode();
+            ObservableArena::deallocate(a, this, sizeof(CallbackNode));
+        }
+    };
+
+    using StoredCallbackPtr = WeakSubscription;
+    using Callbacks = SlotMap<StoredCallbackPtr, ArenaAllocator<StoredCallbackPtr>>;
+
+    /*!< Notifies the callbacks of the current value. */
+    void notify();
+
+    /*!< Runs the callbacks, or queues them in the installed NotificationScheduler. */
+    void deliver(const T& newValue);
+
+    /*!
+     * \brief Notifies the callbacks, or defers the notification if a batch is running.
+     *        current is the stored value, if the caller has it at hand.
+     */
+    void publish(const T *current = nullptr);
+
+    /*!< Delivers a notification deferred by an ObservableBatch. */
+    void flushBatch();
+
+    /*!< Runs the callbacks of a priority queued in a NotificationScheduler. */
+    void dispatch(int priority);
+
+    /*!< Runs the callbacks, or only those of the given priority. */
+    void invoke(const T& value, const int *priority);
+
+    /*!
+     * \brief Whether a list is to be swept before another entry is added:
+     *        it has no vacant slot left, and has grown to twice the live entries found by the last sweep.
+     *        The sweeps thus take O(1) amortized time per entry,
+     *        and keep a list within about twice its largest live size.
+     */
+    template<typename List>
+    static bool sweepDue(const List& list, std::size_t swept)
+    {
+        const std::size_t minSweep = 16;
+        const std::size_t slots = list.slotCount();
+        return (list.size() == slots) && (slots >= minSweep) && (slots >= 2 * swept);
+    }
+
+    /*!< Erases the dead callbacks. */
+    void sweepCallbacks();
+
+    /*!< Erases the bindings to destroyed observables. */
+    void sweepBindings();
+
+    /*!
+     * \brief Stamps the observable with the current epoch.
+     *        An observable the update has already come through, set again,
+     *        e.g. clamped by one of its own callbacks, starts a new epoch:
+     *        the new value is a new origin and has to reach the whole graph once more.
+     */
+    void stamp()
+    {
+        if (visited())
+            Propagation::restart();
+
+        _stamp = Propagation::epoch();
+    }
 
     Callbacks _callbacks;
     bool _fireOnAdd;
-    std::unordered_set<Binding> _bindings;
+    SlotMap<Binding, ArenaAllocator<Binding>> _bindings;
+
+    /*!< Nonzero while the observable is being set or its callbacks are running. */
+    unsigned _notifying;
+    bool _batched;
+    std::uint64_t _stamp;
+    std::uint64_t _version;
+    std::unique_ptr<Comparator> _comparator;
+    ObservableArena *_arena;
+
+    /*!< Whether the observable has ever been recorded or queued by a NotificationScheduler. */
+    bool _scheduled;
+
+    /*!< The live entries left by the last sweep of each list, see sweepDue(). */
+    std::size_t _callbacksSwept;
+    std::size_t _bindingsSwept;
+
+    OBSERVABLE_INSTRUMENT(ObservableStats _stats;)
 };
 
 template<typename T>
 void Observable<T>::set(T value)
 {
-    T oldValue = get();
-    if (value != oldValue)
+    OBSERVABLE_INSTRUMENT(++_stats.sets;)
+
+    if (unchanged(value, stored()))
+    {
+        OBSERVABLE_INSTRUMENT(++_stats.unchangedSets;)
+        return;
+    }
+
+    // Side effects of doSet(), e.g. widget signals, belong to the same update,
+    // and must not be written back.
+    Propagation::Scope scope;
+    stamp();
+    ++_notifying;
+
+    doSet(std::move(value));
+    ++_version;
+    publish();
+    --_notifying;
+}
+
+template<typename T>
+void Observable<T>::setStored(T& storage, T&& value)
+{
+    OBSERVABLE_INSTRUMENT(++_stats.sets;)
+
+    // The default policy is checked here, so that it is inlined along with this function.
+    if (_comparator ? unchanged(value, &storage) : !(value != storage))
+    {
+        OBSERVABLE_INSTRUMENT(++_stats.unchangedSets;)
+        return;
+    }
+
+    Propagation::Scope scope;
+    stamp();
+    ++_notifying;
+
+    storage = std::move(value);
+    ++_version;
+    publish(&storage);
+    --_notifying;
+}
+
+template<typename T>
+void Observable<T>::publish(const T *current)
+{
+    if (!ObservableBatch::active())
+    {
+        if (current)
+            deliver(*current);
+        else
+            notify();
+    }
+    else if (!_batched)
+    {
+        _batched = true;
+        ObservableBatch::defer(this);
+    }
+}
+
+template<typename T>
+bool Observable<T>::unchanged(const T& value, const T *current)
+{
+    if (!_comparator)
+        return current ? !(value != *current) : !(value != get());
+
+    Comparator& c = *_comparator;
+    switch (c.policy)
+    {
+    case Comparison::Equal:
+        return current ? !(value != *current) : !(value != get());
+
+    case Comparison::Always:
+        return false;
+
+    case Comparison::Hash:
     {
-        doSet(value);
-        onChange(get());
+        if (!c.hashed)
+            c.lastHash = current ? c.hash(*current) : c.hash(get());
+
+        const std::size_t h = c.hash(value);
+        const bool same = (h == c.lastHash);
+        c.lastHash = h;
+        c.hashed = true;
+        return same;
     }
+
+    case Comparison::Custom:
+        return current ? c.same(value, *current) : c.same(value, get());
+    }
+
+    return false;
+}
+
+template<typename T>
+void Observable<T>::notify()
+{
+    if (const T *current = stored())
+        deliver(*current);
+    else
+        deliver(get());
 }
 
 template<typename T>
-void Observable<T>::onChange(T newValue)
+void Observable<T>::flushBatch()
 {
-    Callbacks newCallbacks;
-    Callbacks *pNewCallbacks = &newCallbacks;
-    std::for_each(_callbacks.begin(), _callbacks.end(),
-    [newValue, pNewCallbacks] (StoredCallbackPtr& element) {
-        // Note that we are filtering dead callbacks out
-        if (CallbackPtr pCallback = element.lock())
+    _batched = false;
+    notify();
+}
+
+template<typename T>
+void Observable<T>::onChange(const T& newValue)
+{
+    // Subclasses reporting external changes, e.g. from a widget, call onChange() directly.
+    // The value has changed behind set(), so the cached hash is stale.
+    Propagation::Scope scope;
+    stamp();
+    touch();
+
+    ++_notifying;
+    deliver(newValue);
+    --_notifying;
+}
+
+template<typename T>
+void Observable<T>::deliver(const T& newValue)
+{
+    // Derived values depending on this observable are brought up to date
+    // once the outermost notification is over.
+    Propagation::Scope scope;
+
+    if (NotificationScheduler *scheduler = NotificationScheduler::current())
+    {
+        for (std::size_t i = 0; i < _callbacks.slotCount(); ++i)
         {
-            pCallback->operator()(newValue);
-            pNewCallbacks->emplace_back(pCallback);
+            StoredCallbackPtr *stored = _callbacks.at(i);
+            if (stored && !stored->expired())
+                scheduler->enqueue(this, static_cast<CallbackNode *>(stored->node())->priority);
         }
-    });
 
-    _callbacks = newCallbacks;
+        scheduler->changed(this);
+        _scheduled = true;
+        return;
+    }
+
+    invoke(newValue, nullptr);
 }
 
 template<typename T>
-void Observable<T>::removeCallback(CallbackPtr callback)
+void Observable<T>::dispatch(int priority)
 {
-    auto pos = std::find(_callbacks.begin(), _callbacks.end(),
-    [callback] (StoredCallbackPtr & e) {
-        CallbackPtr stored = e.lock();
+    Propagation::Scope scope;
+    if (const T *current = stored())
+    {
+        invoke(*current, &priority);
+    }
+    else
+    {
+        T value = get();
+        invoke(value, &priority);
+    }
+}
+
+template<typename T>
+void Observable<T>::invoke(const T& value, const int *priority)
+{
+    // Callbacks may subscribe, unsubscribe or change this observable again while being notified.
+    // The slots never move and are not reused during a notification,
+    // so the list is walked by slot index and only the callbacks present
+    // at the beginning of the notification are invoked.
+    // Dead callbacks are erased in place, so the notification path does not allocate.
+    const std::size_t count = _callbacks.slotCount();
+
+    OBSERVABLE_INSTRUMENT(++_stats.notifications;)
+    OBSERVABLE_INSTRUMENT(auto start = ObservableStats::Clock::now();)
+
+    // A notification deferred by a batch or a scheduler runs in an update of its own.
+    if (!Propagation::current(_stamp))
+        _stamp = Propagation::epoch();
+
+    ++_notifying;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        StoredCallbackPtr *stored = _callbacks.at(i);
         if (!stored)
-            return false;
+            continue;
 
-        return (stored == callback);
-    });
+        // The strong reference keeps the callback alive
+        // even if it drops its own handle while running.
+        if (CallbackPtr pCallback = stored->lock())
+        {
+            CallbackNode *node = static_cast<CallbackNode *>(pCallback.node());
+            if (priority && (node->priority != *priority))
+                continue;
+
+            node->callback(value);
+            OBSERVABLE_INSTRUMENT(start = _stats.recordCallback(node->latency, start);)
+        }
+        else
+        {
+            OBSERVABLE_INSTRUMENT(++_stats.prunes; _stats.forgetCallback(stored->node());)
+            _callbacks.eraseAt(i);
+        }
+    }
+    --_notifying;
+
+    OBSERVABLE_INSTRUMENT(_stats.subscribers = _callbacks.size();)
+}
+
+template<typename T>
+void Observable<T>::removeCallback(const CallbackPtr& callback)
+{
+    SubscriptionNode *node = callback.node();
+    if (!node)
+        return;
+
+    StoredCallbackPtr *stored = _callbacks.find(node->slot);
+    if (stored && (stored->node() == node))
+    {
+        OBSERVABLE_INSTRUMENT(_stats.forgetCallback(node);)
+        _callbacks.erase(node->slot);
+        OBSERVABLE_INSTRUMENT(_stats.subscribers = _callbacks.size();)
+    }
+}
+
+template<typename T>
+bool Observable<T>::hasCallbacks()
+{
+    for (std::size_t i = 0; i < _callbacks.slotCount(); ++i)
+    {
+        StoredCallbackPtr *stored = _callbacks.at(i);
+        if (stored && !stored->expired())
+            return true;
+    }
+
+    return false;
+}
+
+template<typename T>
+void Observable<T>::sweepCallbacks()
+{
+    for (std::size_t i = 0; i < _callbacks.slotCount(); ++i)
+    {
+        StoredCallbackPtr *stored = _callbacks.at(i);
+        if (stored && stored->expired())
+        {
+            OBSERVABLE_INSTRUMENT(++_stats.prunes; _stats.forgetCallback(stored->node());)
+            _callbacks.eraseAt(i);
+        }
+    }
 
-    if (pos != _callbacks.end())
-        _callbacks.erase(pos);
+    _callbacksSwept = _callbacks.size();
+    OBSERVABLE_INSTRUMENT(_stats.subscribers = _callbacks.size();)
+}
+
+template<typename T>
+void Observable<T>::sweepBindings()
+{
+    for (std::size_t i = 0; i < _bindings.slotCount(); ++i)
+    {
+        Binding *binding = _bindings.at(i);
+        if (binding && (!binding->node() || binding->node()->detached()))
+            _bindings.eraseAt(i);
+    }
+
+    _bindingsSwept = _bindings.size();
+}
+
+template<typename T>
+void Observable<T>::compact()
+{
+    sweepCallbacks();
+    sweepBindings();
+    _bindings.shrink();
+
+    // A running notification walks the callbacks by slot index.
+    if (_notifying == 0)
+        _callbacks.shrink();
+}
+
+template<typename T>
+ObservableMemory Observable<T>::memory()
+{
+    ObservableMemory m;
+    m.callbackBytes = _callbacks.bytes();
+    for (std::size_t i = 0; i < _callbacks.slotCount(); ++i)
+    {
+        StoredCallbackPtr *stored = _callbacks.at(i);
+        if (!stored || !stored->node())
+            continue;
+
+        SubscriptionNode *node = stored->node();
+        if (node->alive())
+            ++m.callbacks;
+        else
+            ++m.deadCallbacks;
+
+        m.callbackBytes += node->bytes();
+        m.captureBytes += node->captureBytes();
+    }
+
+    m.bindingBytes = _bindings.bytes();
+    for (std::size_t i = 0; i < _bindings.slotCount(); ++i)
+    {
+        Binding *binding = _bindings.at(i);
+        if (!binding || !binding->node())
+            continue;
+
+        SubscriptionNode *node = binding->node();
+        if (node->detached())
+        {
+            ++m.deadBindings;
+            m.bindingBytes += node->bytes();
+            m.captureBytes += node->captureBytes();
+        }
+        else
+        {
+            ++m.bindings;
+        }
+    }
+
+    return m;
 }
 
 template<typename T>
@@ -238,35 +900,21 @@ std::pair<typename Observable<T>::BindingHandle,
             typename Observable<T>::BindingHandle>
 Observable<T>::bindTwoWay(Observable<T>& other)
 {
-    std::shared_ptr<bool> lock(new bool(false));
-
     Binding b1 = other.addCallback(
-                [this, lock](T value)
+                [this](const T& value)
                 {
-                    if (*lock)
-                        return;
-                    else
-                        *lock = true;
-
-                    this->set(value);
-
-                    *lock = false;
+                    if (!this->visited())
+                        this->set(value);
                 });
 
     BindingHandle h1 = addBinding(b1);
 
     Observable<T> *pOther = &other;
     CallbackPtr observeThis = addCallback(
-                [pOther, lock](T value)
+                [pOther](const T& value)
                 {
-                    if (*lock)
-                        return;
-                    else
-                        *lock = true;
-
-                    pOther->set(value);
-
-                    *lock = false;
+                    if (!pOther->visited())
+                        pOther->set(value);
                 });
 
     BindingHandle h2 = other.addBinding(observeThis);
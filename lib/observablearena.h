@@ -0,0 +1,252 @@
+#ifndef OBSERVABLEARENA_H
+#define OBSERVABLEARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <vector>
+
+/*!
+ * \brief A memory pool for the observables and their subscription bookkeeping,
+ *        e.g. of a view model with hundreds of fields.
+ *
+ *        Small blocks are carved from a few large chunks and recycled by size class,
+ *        so that building a model takes a handful of allocations
+ *        instead of several per observable, and keeps its data close together.
+ *
+ *        Observables constructed while a Scope is open allocate from the scope's arena,
+ *        including the callbacks subscribed to them later:
+ *
+ *        ObservableArena::Ref arena = ObservableArena::create();
+ *        ObservableArena::Scope scope(arena.get());
+ *        auto model = std::allocate_shared<Model>(ArenaAllocator<Model>(arena.get()));
+ *
+ *        The arena is reference counted: the observables and every block allocated from it
+ *        keep it alive, so it is released with the last of them.
+ *        Like the observables, an arena must only be used by a single thread.
+ */
+class ObservableArena
+{
+public:
+    /*!< A strong reference to an arena. */
+    class Ref
+    {
+    public:
+        Ref() : _arena(nullptr) {}
+        explicit Ref(ObservableArena *arena) : _arena(arena) { retain(_arena); }
+        Ref(const Ref& other) : _arena(other._arena) { retain(_arena); }
+        ~Ref() { ObservableArena::release(_arena); }
+
+        Ref& operator=(Ref other)
+        {
+            std::swap(_arena, other._arena);
+            return *this;
+        }
+
+        ObservableArena *get() const { return _arena; }
+        ObservableArena *operator->() const { return _arena; }
+
+    private:
+        ObservableArena *_arena;
+    };
+
+    /*!< An RAII marker making an arena the current one of this thread. */
+    class Scope
+    {
+    public:
+        explicit Scope(ObservableArena *arena) : _previous(current())
+        {
+            currentSlot() = arena;
+        }
+
+        ~Scope() { currentSlot() = _previous; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ObservableArena *_previous;
+    };
+
+    static Ref create(std::size_t chunkSize = 4096)
+    {
+        return Ref(new ObservableArena(chunkSize));
+    }
+
+    /*!< The arena of the innermost open scope, or nullptr. */
+    static ObservableArena *current() { return currentSlot(); }
+
+    /*!
+     * \brief Allocates a block from the arena, or from the heap if the arena is nullptr.
+     *        The blocks are aligned for any fundamental type.
+     */
+    static void *allocate(ObservableArena *arena, std::size_t size)
+    {
+        if (!arena || (size > maxPooled))
+            return ::operator new(size);
+
+        return arena->take(size);
+    }
+
+    /*!< Returns a block allocated with the same arena and size. */
+    static void deallocate(ObservableArena *arena, void *p, std::size_t size)
+    {
+        if (!arena || (size > maxPooled))
+        {
+            ::operator delete(p);
+            return;
+        }
+
+        arena->give(p, size);
+    }
+
+    static void retain(ObservableArena *arena)
+    {
+        if (arena)
+            ++arena->_references;
+    }
+
+    static void release(ObservableArena *arena)
+    {
+        if (arena && (--arena->_references == 0))
+            delete arena;
+    }
+
+    /*!< Number of chunks allocated from the heap so far. */
+    std::size_t chunkCount() const { return _chunks.size(); }
+
+    /*!< Number of bytes reserved from the heap. */
+    std::size_t reserved() const { return _reserved; }
+
+private:
+    static const std::size_t granularity = alignof(std::max_align_t);
+    static const std::size_t maxPooled = 512;
+    static const std::size_t maxChunk = 64 * 1024;
+
+    /*!< A recycled block, chained into the free list of its size class. */
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    explicit ObservableArena(std::size_t chunkSize) :
+        _references(0), _chunkSize(chunkSize), _cursor(nullptr), _end(nullptr), _reserved(0), _reservedLast(0)
+    {
+        std::fill(std::begin(_free), std::end(_free), nullptr);
+    }
+
+    ~ObservableArena()
+    {
+        for (char *chunk : _chunks)
+            ::operator delete(chunk);
+    }
+
+    ObservableArena(const ObservableArena&) = delete;
+    ObservableArena& operator=(const ObservableArena&) = delete;
+
+    static ObservableArena *&currentSlot()
+    {
+        static thread_local ObservableArena *arena = nullptr;
+        return arena;
+    }
+
+    static std::size_t sizeClass(std::size_t size)
+    {
+        return std::max<std::size_t>(1, (size + granularity - 1) / granularity);
+    }
+
+    void *take(std::size_t size)
+    {
+        // Every block holds a reference, so that the arena outlives whatever is allocated from it.
+        ++_references;
+
+        const std::size_t c = sizeClass(size);
+        if (FreeBlock *block = _free[c])
+        {
+            _free[c] = block->next;
+            return block;
+        }
+
+        const std::size_t bytes = c * granularity;
+        if (std::size_t(_end - _cursor) < bytes)
+            grow(bytes);
+
+        void *p = _cursor;
+        _cursor += bytes;
+        return p;
+    }
+
+    void give(void *p, std::size_t size)
+    {
+        const std::size_t c = sizeClass(size);
+        FreeBlock *block = static_cast<FreeBlock *>(p);
+        block->next = _free[c];
+        _free[c] = block;
+
+        release(this);
+    }
+
+    /*!< Starts a new chunk, each one twice as large as the previous one, up to maxChunk. */
+    void grow(std::size_t bytes)
+    {
+        std::size_t size = _chunkSize;
+        if (!_chunks.empty())
+            size = (2 * _reservedLast < maxChunk) ? 2 * _reservedLast : std::size_t(maxChunk);
+
+        size = std::max(size, bytes);
+        char *chunk = static_cast<char *>(::operator new(size));
+        _chunks.push_back(chunk);
+        _reserved += size;
+        _reservedLast = size;
+
+        // The tail of the previous chunk is simply abandoned.
+        _cursor = chunk;
+        _end = chunk + size;
+    }
+
+    unsigned _references;
+    std::size_t _chunkSize;
+    char *_cursor;
+    char *_end;
+    std::size_t _reserved;
+    std::size_t _reservedLast;
+    FreeBlock *_free[maxPooled / granularity + 1];
+    std::vector<char *> _chunks;
+};
+
+/*!
+ * \brief A standard allocator over an ObservableArena, e.g. for std::allocate_shared
+ *        or the containers of the observables. A nullptr arena allocates from the heap.
+ */
+template<typename T>
+struct ArenaAllocator
+{
+    using value_type = T;
+
+    ObservableArena *arena;
+
+    ArenaAllocator(ObservableArena *a = nullptr) : arena(a) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T *allocate(std::size_t n)
+    {
+        return static_cast<T *>(ObservableArena::allocate(arena, n * sizeof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n)
+    {
+        ObservableArena::deallocate(arena, p, n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+#endif // OBSERVABLEARENA_H
@@ -0,0 +1,103 @@
+#ifndef OBSERVABLEBATCH_H
+#define OBSERVABLEBATCH_H
+
+#include <algorithm>
+#include <vector>
+
+/*!
+ * \brief Something that has a change notification deferred by an ObservableBatch.
+ *        Implemented by Observable.
+ */
+class BatchParticipant
+{
+public:
+    /*!< Delivers the deferred notification. */
+    virtual void flushBatch() = 0;
+
+protected:
+    ~BatchParticipant() {}
+};
+
+/*!
+ * \brief An RAII batch of observable updates.
+ *        While a batch exists on the current thread, set() still stores new values immediately,
+ *        but the change notifications are deferred. When the outermost batch ends,
+ *        every changed observable notifies its callbacks once, with its final value,
+ *        in the order the observables were first changed.
+ *        Batches nest: only the outermost one flushes.
+ *
+ *        {
+ *            ObservableBatch batch;
+ *            vm.caption().set(...);
+ *            vm.text().set(...);
+ *        } // callbacks fire here
+ */
+class ObservableBatch
+{
+public:
+    ObservableBatch() { ++state().depth; }
+
+    ~ObservableBatch()
+    {
+        if (--state().depth == 0)
+            flush();
+    }
+
+    ObservableBatch(const ObservableBatch&) = delete;
+    ObservableBatch& operator=(const ObservableBatch&) = delete;
+
+    /*!< Whether notifications on the current thread are deferred. */
+    static bool active() { return state().depth > 0; }
+
+    /*!< Defers a participant's notification until the outermost batch ends. */
+    static void defer(BatchParticipant *participant)
+    {
+        state().pending.push_back(participant);
+    }
+
+    /*!< Drops a deferred notification, e.g. when the participant is destroyed. */
+    static void forget(BatchParticipant *participant)
+    {
+        std::vector<BatchParticipant *>& pending = state().pending;
+        std::replace(pending.begin(), pending.end(), participant,
+                     static_cast<BatchParticipant *>(nullptr));
+    }
+
+private:
+    struct State
+    {
+        unsigned depth = 0;
+        std::vector<BatchParticipant *> pending;
+    };
+
+    static State& state()
+    {
+        static thread_local State s;
+        return s;
+    }
+
+    /*!
+     * \brief Notifies the pending participants.
+     *        Changes made by their callbacks are not batched anymore,
+     *        unless a callback opens a batch of its own.
+     */
+    static void flush()
+    {
+        // Callbacks may destroy pending participants (forget() clears them in place)
+        // or open a nested batch that flushes the rest of the list,
+        // so the list is walked by index and each entry is cleared before it is flushed.
+        std::vector<BatchParticipant *>& pending = state().pending;
+        for (std::size_t i = 0; i < pending.size(); ++i)
+        {
+            if (BatchParticipant *participant = pending[i])
+            {
+                pending[i] = nullptr;
+                participant->flushBatch();
+            }
+        }
+
+        pending.clear();
+    }
+};
+
+#endif // OBSERVABLEBATCH_H
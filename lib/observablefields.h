@@ -0,0 +1,414 @@
+#ifndef OBSERVABLEFIELDS_H
+#define OBSERVABLEFIELDS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "binarycodec.h"
+#include "observablearena.h"
+#include "observablebatch.h"
+#include "sharedvalueobservable.h"
+#include "valueobservable.h"
+
+/*!
+ * \brief An immutable copy of the values of the fields registered in an ObservableFields.
+ *        The values are shared, so copying a snapshot does not copy them,
+ *        and snapshots taken one after another share the values that have not changed.
+ */
+class ObservableSnapshot
+{
+public:
+    ObservableSnapshot() : _owner(0) {}
+
+    std::size_t size() const { return _entries.size(); }
+    bool empty() const { return _entries.empty(); }
+
+private:
+    friend class ObservableFields;
+
+    struct Entry
+    {
+        std::shared_ptr<const void> value;
+        const void *type;
+        std::uint64_t version;
+    };
+
+    /*!< The id of the registry that has taken the snapshot, 0 if none. */
+    std::uint64_t _owner;
+    std::vector<Entry> _entries;
+};
+
+/*!
+ * \brief A registry of the ValueObservable fields of a view model,
+ *        letting the model be copied, snapshot and restored as a whole:
+ *
+ *        MainViewModel::MainViewModel()
+ *        {
+ *            _fields.add(_text);
+ *            _fields.add(_size);
+ *        }
+ *
+ *        The SharedValueObservable fields are snapshot, restored and copied
+ *        by sharing their values instead of copying them.
+ *        Registries of the same kind of model have the same layout,
+ *        so a snapshot of one model may be restored into another.
+ *        A field whose type differs from the snapshot's one is left alone.
+ *        The registry keeps references to the fields and must not outlive them.
+ */
+class ObservableFields
+{
+public:
+    ObservableFields() : _id(nextId()), _fields(ArenaAllocator<Field>(ObservableArena::current())) {}
+
+    ObservableFields(const ObservableFields&) = delete;
+    ObservableFields& operator=(const ObservableFields&) = delete;
+
+    template<typename T>
+    void add(ValueObservable<T>& field)
+    {
+        _fields.push_back(Field { &field, opsFor<T>() });
+    }
+
+    template<typename T>
+    void add(SharedValueObservable<T>& field)
+    {
+        _fields.push_back(Field { &field, sharedOpsFor<T>() });
+    }
+
+    std::size_t size() const { return _fields.size(); }
+
+    /*!
+     * \brief Copies the values of the fields.
+     *        The values of the fields that have not changed since a previous snapshot
+     *        of this registry, passed as the base, are shared with it instead of being copied.
+     */
+    ObservableSnapshot snapshot(const ObservableSnapshot& base = ObservableSnapshot()) const;
+
+    /*!
+     * \brief Sets the fields to the snapshot's values.
+     *        With notify, the changed fields notify their callbacks once all of them are set,
+     *        otherwise the values are assigned silently.
+     */
+    void restore(const ObservableSnapshot& snapshot, bool notify = true);
+
+    /*!
+     * \brief Copies the values into the fields of another registry without notifications,
+     *        e.g. to clone a model. Each value is copied once.
+     */
+    void copyTo(ObservableFields& other) const;
+
+    /*!
+     * \brief Writes the values into a compact binary image, see BinaryCodec.
+     *        The fields whose type has no codec, or whose value takes 4 GiB or more,
+     *        are stored empty, and not loaded back.
+     */
+    std::vector<char> save() const;
+
+    /*!
+     * \brief Sets the fields to the values of an image written by save(),
+     *        e.g. a memory-mapped file. The values are read in place,
+     *        the entries are aligned to 8 bytes if the image is.
+     *        As with restore(), with notify the changed fields notify their callbacks
+     *        once all of them are set, otherwise the values are assigned silently.
+     *        A malformed image changes nothing, and false is returned.
+     */
+    bool load(const void *data, std::size_t size, bool notify = false);
+
+private:
+    /*!< The type dependent operations of a field. Also identify the field's type. */
+    struct Ops
+    {
+        std::shared_ptr<const void> (*capture)(const void *field);
+        void (*restore)(void *field, const std::shared_ptr<const void>& value, bool notify);
+        void (*copy)(const void *from, void *to);
+        std::uint64_t (*version)(const void *field);
+
+        /*!< The stored type, 0 if it has no codec. */
+        std::uint32_t tag;
+        void (*write)(const void *field, std::vector<char>& out);
+        bool (*fits)(std::size_t size);
+        void (*read)(void *field, const char *data, std::size_t size, bool notify);
+    };
+
+    /*!< The binary operations of a field of class O holding a T. */
+    template<typename T, typename O, bool supported = BinaryCodec<T>::supported>
+    struct Binary
+    {
+        static std::uint32_t tag() { return binaryTypeTag<T>(); }
+
+        static void write(const void *p, std::vector<char>& out)
+        {
+            BinaryCodec<T>::write(static_cast<const O *>(p)->value(), out);
+        }
+
+        static bool fits(std::size_t size) { return BinaryCodec<T>::fits(size); }
+
+        static void read(void *p, const char *data, std::size_t size, bool notify)
+        {
+            O& field = *static_cast<O *>(p);
+            if (notify)
+                field.set(BinaryCodec<T>::read(data, size));
+            else
+                field.assign(BinaryCodec<T>::read(data, size));
+        }
+    };
+
+    template<typename T, typename O>
+    struct Binary<T, O, false>
+    {
+        static std::uint32_t tag() { return 0; }
+        static void write(const void *, std::vector<char>&) {}
+        static bool fits(std::size_t) { return false; }
+        static void read(void *, const char *, std::size_t, bool) {}
+    };
+
+    /*!< The image starts with a header, followed by an entry per field. */
+    struct ImageHeader
+    {
+        char magic[4];
+        std::uint32_t format;
+        std::uint64_t count;
+    };
+
+    /*!< An entry is followed by its value bytes, padded to 8 bytes. */
+    struct ImageEntry
+    {
+        std::uint32_t tag;
+        std::uint32_t size;
+    };
+
+    static const std::uint32_t imageFormat = 1;
+
+    static std::size_t padded(std::size_t size) { return (size + 7) & ~std::size_t(7); }
+
+    struct Field
+    {
+        void *observable;
+        const Ops *ops;
+    };
+
+    template<typename T>
+    static const Ops *opsFor();
+
+    template<typename T>
+    static const Ops *sharedOpsFor();
+
+    /*!< Unique in the process, unlike the address of a registry, which a later one may reuse. */
+    static std::uint64_t nextId()
+    {
+        static std::atomic<std::uint64_t> last(0);
+        return ++last;
+    }
+
+    /*!< Identifies the snapshots taken by this registry, see snapshot(). */
+    const std::uint64_t _id;
+    std::vector<Field, ArenaAllocator<Field>> _fields;
+};
+
+template<typename T>
+const ObservableFields::Ops *ObservableFields::opsFor()
+{
+    struct Impl
+    {
+        static const ValueObservable<T>& field(const void *p) { return *static_cast<const ValueObservable<T> *>(p); }
+        static ValueObservable<T>& field(void *p) { return *static_cast<ValueObservable<T> *>(p); }
+
+        static std::shared_ptr<const void> capture(const void *p)
+        {
+            return std::make_shared<T>(field(p).value());
+        }
+
+        static void restore(void *p, const std::shared_ptr<const void>& value, bool notify)
+        {
+            const T& v = *static_cast<const T *>(value.get());
+            if (notify)
+                field(p).set(v);
+            else
+                field(p).assign(v);
+        }
+
+        static void copy(const void *from, void *to)
+        {
+            field(to).assign(field(from).value());
+        }
+
+        static std::uint64_t version(const void *p)
+        {
+            return field(p).version();
+        }
+    };
+
+    using B = Binary<T, ValueObservable<T>>;
+    static const Ops ops = { &Impl::capture, &Impl::restore, &Impl::copy, &Impl::version,
+                             B::tag(), &B::write, &B::fits, &B::read };
+    return &ops;
+}
+
+template<typename T>
+const ObservableFields::Ops *ObservableFields::sharedOpsFor()
+{
+    struct Impl
+    {
+        static const SharedValueObservable<T>& field(const void *p) { return *static_cast<const SharedValueObservable<T> *>(p); }
+        static SharedValueObservable<T>& field(void *p) { return *static_cast<SharedValueObservable<T> *>(p); }
+
+        static std::shared_ptr<const void> capture(const void *p)
+        {
+            return field(p).snapshot();
+        }
+
+        static void restore(void *p, const std::shared_ptr<const void>& value, bool notify)
+        {
+            std::shared_ptr<const T> v = std::static_pointer_cast<const T>(value);
+            if (notify)
+                field(p).setSnapshot(std::move(v));
+            else
+                field(p).assign(std::move(v));
+        }
+
+        static void copy(const void *from, void *to)
+        {
+            field(to).assign(field(from).snapshot());
+        }
+
+        static std::uint64_t version(const void *p)
+        {
+            return field(p).version();
+        }
+    };
+
+    using B = Binary<T, SharedValueObservable<T>>;
+    static const Ops ops = { &Impl::capture, &Impl::restore, &Impl::copy, &Impl::version,
+                             B::tag(), &B::write, &B::fits, &B::read };
+    return &ops;
+}
+
+inline ObservableSnapshot ObservableFields::snapshot(const ObservableSnapshot& base) const
+{
+    const bool incremental = (base._owner == _id) && (base._entries.size() == _fields.size());
+
+    ObservableSnapshot result;
+    result._owner = _id;
+    result._entries.reserve(_fields.size());
+    for (std::size_t i = 0; i < _fields.size(); ++i)
+    {
+        const Field& f = _fields[i];
+        const std::uint64_t version = f.ops->version(f.observable);
+
+        if (incremental && (base._entries[i].version == version))
+            result._entries.push_back(base._entries[i]);
+        else
+            result._entries.push_back(ObservableSnapshot::Entry { f.ops->capture(f.observable), f.ops, version });
+    }
+
+    return result;
+}
+
+inline void ObservableFields::restore(const ObservableSnapshot& snapshot, bool notify)
+{
+    ObservableBatch batch;
+
+    const std::size_t count = std::min(snapshot._entries.size(), _fields.size());
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const Field& f = _fields[i];
+        const ObservableSnapshot::Entry& e = snapshot._entries[i];
+        if (e.type == f.ops)
+            f.ops->restore(f.observable, e.value, notify);
+    }
+}
+
+inline void ObservableFields::copyTo(ObservableFields& other) const
+{
+    const std::size_t count = std::min(_fields.size(), other._fields.size());
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const Field& from = _fields[i];
+        const Field& to = other._fields[i];
+        if (from.ops == to.ops)
+            from.ops->copy(from.observable, to.observable);
+    }
+}
+
+inline std::vector<char> ObservableFields::save() const
+{
+    std::vector<char> image(sizeof(ImageHeader));
+    image.reserve(sizeof(ImageHeader) + 16 * _fields.size());
+    ImageHeader header = { { 'O', 'B', 'S', 'F' }, imageFormat, _fields.size() };
+    std::memcpy(image.data(), &header, sizeof(header));
+
+    for (const Field& f : _fields)
+    {
+        const std::size_t at = image.size();
+        image.resize(at + sizeof(ImageEntry));
+        f.ops->write(f.observable, image);
+
+        const std::size_t size = image.size() - at - sizeof(ImageEntry);
+        ImageEntry entry = { f.ops->tag, std::uint32_t(size) };
+
+        // An entry's size has 32 bits, a larger value would make the image unreadable.
+        if (size > std::numeric_limits<std::uint32_t>::max())
+        {
+            entry = ImageEntry { 0, 0 };
+            image.resize(at + sizeof(ImageEntry));
+        }
+
+        std::memcpy(image.data() + at, &entry, sizeof(entry));
+        image.resize(at + padded(image.size() - at));
+    }
+
+    return image;
+}
+
+inline bool ObservableFields::load(const void *data, std::size_t size, bool notify)
+{
+    const char *bytes = static_cast<const char *>(data);
+
+    ImageHeader header;
+    if (!bytes || (size < sizeof(header)))
+        return false;
+
+    std::memcpy(&header, bytes, sizeof(header));
+    if ((std::memcmp(header.magic, "OBSF", 4) != 0) || (header.format != imageFormat))
+        return false;
+
+    // The entries are checked before any field is set, so that a truncated image changes nothing.
+    std::size_t at = sizeof(header);
+    for (std::uint64_t i = 0; i < header.count; ++i)
+    {
+        ImageEntry entry;
+        if (size - at < sizeof(entry))
+            return false;
+
+        std::memcpy(&entry, bytes + at, sizeof(entry));
+        if (size - at - sizeof(entry) < entry.size)
+            return false;
+
+        at += padded(sizeof(entry) + entry.size);
+        at = std::min(at, size);
+    }
+
+    ObservableBatch batch;
+
+    at = sizeof(header);
+    const std::size_t count = std::min<std::size_t>(header.count, _fields.size());
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        ImageEntry entry;
+        std::memcpy(&entry, bytes + at, sizeof(entry));
+        const char *value = bytes + at + sizeof(entry);
+        at += padded(sizeof(entry) + entry.size);
+
+        const Field& f = _fields[i];
+        if ((entry.tag != 0) && (entry.tag == f.ops->tag) && f.ops->fits(entry.size))
+            f.ops->read(f.observable, value, entry.size, notify);
+    }
+
+    return true;
+}
+
+#endif // OBSERVABLEFIELDS_H
@@ -0,0 +1,110 @@
+#ifndef OBSERVABLELISTMODEL_H
+#define OBSERVABLELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <functional>
+#include "observablevector.h"
+
+/*!
+ * \brief A Qt item model presenting an ObservableVector to the item views.
+ *
+ *        The change records of the vector are translated to the row insertion,
+ *        removal, move and dataChanged notifications,
+ *        so that the views only repaint the affected rows.
+ *        The data function maps an item and a role to the displayed value:
+ *
+ *        ObservableListModel<Contact> model(contacts,
+ *            [](const Contact& c, int role) {
+ *                return (role == Qt::DisplayRole) ? QVariant(c.name) : QVariant();
+ *            });
+ *
+ *        The vector must outlive the model.
+ */
+template<typename T>
+class ObservableListModel : public QAbstractListModel
+{
+public:
+    using Data = std::function<QVariant (const T& item, int role)>;
+
+    ObservableListModel(ObservableVector<T>& items, Data data, QObject *parent = nullptr) :
+        QAbstractListModel(parent), _items(items), _data(std::move(data)), _rows(int(items.size()))
+    {
+        _subscription = _items.changes().addCallback(
+                    [this](const VectorChanges& changes) { this->apply(changes); });
+    }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const
+    {
+        return parent.isValid() ? 0 : _rows;
+    }
+
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const
+    {
+        // While the records of a change are being applied,
+        // the row count may be ahead of the vector.
+        if (!index.isValid() || (std::size_t(index.row()) >= _items.size()))
+            return QVariant();
+
+        return _data(_items[index.row()], role);
+    }
+
+private:
+    void apply(const VectorChanges& changes);
+
+    ObservableVector<T>& _items;
+    Data _data;
+    Subscription _subscription;
+
+    /*!
+     * \brief The row count the views know about.
+     *        The vector is already changed when the records arrive,
+     *        so the count is tracked separately, record by record.
+     */
+    int _rows;
+};
+
+template<typename T>
+void ObservableListModel<T>::apply(const VectorChanges& changes)
+{
+    for (const VectorChange& c : changes)
+    {
+        const int first = int(c.first);
+        const int last = int(c.first + c.count) - 1;
+
+        switch (c.kind)
+        {
+        case VectorChange::Insert:
+            beginInsertRows(QModelIndex(), first, last);
+            _rows += int(c.count);
+            endInsertRows();
+            break;
+
+        case VectorChange::Remove:
+            beginRemoveRows(QModelIndex(), first, last);
+            _rows -= int(c.count);
+            endRemoveRows();
+            break;
+
+        case VectorChange::Move:
+        {
+            // Qt takes the destination row before the move.
+            const int destination = (c.to < c.first) ? int(c.to) : int(c.to + c.count);
+            if (beginMoveRows(QModelIndex(), first, last, QModelIndex(), destination))
+                endMoveRows();
+            break;
+        }
+
+        case VectorChange::Update:
+            emit dataChanged(index(first), index(last));
+            break;
+
+        case VectorChange::Reset:
+            beginResetModel();
+            _rows = int(_items.size());
+            endResetModel();
+            break;
+        }
+    }
+}
+
+#endif // OBSERVABLELISTMODEL_H
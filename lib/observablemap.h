@@ -0,0 +1,314 @@
+#ifndef OBSERVABLEMAP_H
+#define OBSERVABLEMAP_H
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "changestream.h"
+#include "flathashmap.h"
+#include "inlinefunction.h"
+#include "observablebatch.h"
+#include "propagation.h"
+#include "subscription.h"
+
+/*!
+ * \brief A change record of an ObservableMap.
+ */
+template<typename K>
+struct MapChange
+{
+    enum Kind { Inserted, Updated, Removed };
+
+    K key;
+    Kind kind;
+
+    MapChange(const K& k, Kind kd) : key(k), kind(kd) {}
+
+    bool operator==(const MapChange& other) const { return (kind == other.kind) && (key == other.key); }
+    bool operator!=(const MapChange& other) const { return !(*this == other); }
+};
+
+/*!
+ * \brief An observable keyed collection, e.g. of quotes by instrument.
+ *
+ *        The entries are kept in a flat open addressing table, see FlatHashMap,
+ *        instead of a separately allocated observable per key.
+ *        Subscribers may watch a single key, and are only woken up by the changes of that key,
+ *        or the whole map, receiving the set of changed keys, see changes().
+ *
+ *        Changes made within an ObservableBatch are delivered at once, one record per key:
+ *        a key inserted and updated is reported as inserted,
+ *        removed and inserted again as updated,
+ *        inserted and removed as removed.
+ *
+ *        The value type must be comparable, the values equal to the current ones are dropped.
+ */
+template<typename K, typename V, typename H = std::hash<K>>
+class ObservableMap : private BatchParticipant
+{
+public:
+    using Changes = std::vector<MapChange<K>>;
+
+    /*!< A key callback receives the key's value, or nullptr if there is no such key anymore. */
+    using KeyCallback = InlineFunction<void (const V *value)>;
+
+    ObservableMap() : _notifying(0), _batched(false) {}
+
+    ObservableMap(const ObservableMap&) = delete;
+    ObservableMap& operator=(const ObservableMap&) = delete;
+
+    virtual ~ObservableMap()
+    {
+        if (_batched)
+            ObservableBatch::forget(this);
+    }
+
+    /*!< The key's value, or nullptr. Valid until the map is changed. */
+    const V *find(const K& key) const { return _entries.find(key); }
+
+    bool contains(const K& key) const { return _entries.find(key) != nullptr; }
+    std::size_t size() const { return _entries.size(); }
+    bool empty() const { return _entries.empty(); }
+
+    /*!< Calls f(key, value) for every entry in no particular order. */
+    template<typename F>
+    void forEach(F f) const { _entries.forEach(f); }
+
+    /*!< Inserts or updates an entry. */
+    void set(const K& key, V value);
+
+    /*!< Removes an entry. Returns whether there was one. */
+    bool remove(const K& key);
+
+    void clear();
+
+    /*!
+     * \brief Watches a single key, whether it is present or not.
+     *        The callback is executed immediately upon adding, like the Observable callbacks,
+     *        and stays subscribed as long as the returned handle, or a copy of it, lives.
+     */
+    template<typename F>
+    Subscription watch(const K& key, F callback);
+
+    /*!< The change records of the whole map. */
+    ChangeStream<Changes>& changes() { return _changes; }
+
+private:
+    struct WatchNode : public SubscriptionNode
+    {
+        template<typename F>
+        explicit WatchNode(F&& block) : callback(std::forward<F>(block)) {}
+
+        KeyCallback callback;
+
+        std::size_t bytes() const { return sizeof(WatchNode); }
+        std::size_t captureBytes() const { return callback.heapBytes(); }
+
+    protected:
+        void dispose() { callback = nullptr; }
+    };
+
+    using Watchers = std::vector<WeakSubscription>;
+
+    void record(const K& key, typename MapChange<K>::Kind kind);
+
+    /*!< Delivers the pending changes, unless a batch defers them. */
+    void publish();
+
+    void flushBatch()
+    {
+        _batched = false;
+        deliver();
+    }
+
+    void deliver();
+    void notifyKey(const K& key);
+
+    /*!< Drops the dead subscriptions of a key, and the key itself if none are left. */
+    void prune(const K& key);
+
+    static void dropExpired(Watchers& list)
+    {
+        list.erase(std::remove_if(list.begin(), list.end(),
+                                  [](const WeakSubscription& w) { return w.expired(); }),
+                   list.end());
+    }
+
+    FlatHashMap<K, V, H> _entries;
+
+    // The lists are allocated separately, so that they stay in place
+    // while the table is rehashed by a callback watching a new key.
+    FlatHashMap<K, std::unique_ptr<Watchers>, H> _watchers;
+
+    Changes _pending;
+
+    /*!< Positions of the keys in _pending, used to merge the records of a batch. */
+    FlatHashMap<K, std::size_t, H> _pendingIndex;
+
+    ChangeStream<Changes> _changes;
+    unsigned _notifying;
+    bool _batched;
+};
+
+template<typename K, typename V, typename H>
+void ObservableMap<K, V, H>::set(const K& key, V value)
+{
+    std::pair<V *, bool> entry = _entries.insert(key);
+    if (!entry.second && !(value != *entry.first))
+        return;
+
+    *entry.first = std::move(value);
+    record(key, entry.second ? MapChange<K>::Inserted : MapChange<K>::Updated);
+    publish();
+}
+
+template<typename K, typename V, typename H>
+bool ObservableMap<K, V, H>::remove(const K& key)
+{
+    if (!_entries.erase(key))
+        return false;
+
+    record(key, MapChange<K>::Removed);
+    publish();
+    return true;
+}
+
+template<typename K, typename V, typename H>
+void ObservableMap<K, V, H>::clear()
+{
+    if (_entries.empty())
+        return;
+
+    std::vector<K> keys;
+    keys.reserve(_entries.size());
+    _entries.forEach([&keys](const K& key, const V&) { keys.push_back(key); });
+    _entries.clear();
+
+    for (const K& key : keys)
+        record(key, MapChange<K>::Removed);
+
+    publish();
+}
+
+template<typename K, typename V, typename H>
+template<typename F>
+Subscription ObservableMap<K, V, H>::watch(const K& key, F callback)
+{
+    WatchNode *node = new WatchNode(std::move(callback));
+    Subscription handle(node);
+
+    std::pair<std::unique_ptr<Watchers> *, bool> list = _watchers.insert(key);
+    if (list.second)
+        list.first->reset(new Watchers());
+    else if (_notifying == 0)
+        dropExpired(**list.first);
+
+    (*list.first)->push_back(WeakSubscription(handle));
+
+    node->callback(_entries.find(key));
+    return handle;
+}
+
+template<typename K, typename V, typename H>
+void ObservableMap<K, V, H>::record(const K& key, typename MapChange<K>::Kind kind)
+{
+    if (ObservableBatch::active())
+    {
+        std::pair<std::size_t *, bool> index = _pendingIndex.insert(key);
+        if (!index.second)
+        {
+            MapChange<K>& change = _pending[*index.first];
+            if ((change.kind == MapChange<K>::Inserted) && (kind == MapChange<K>::Updated))
+                return;
+
+            change.kind = ((change.kind == MapChange<K>::Removed) && (kind == MapChange<K>::Inserted))
+                    ? MapChange<K>::Updated : kind;
+            return;
+        }
+
+        *index.first = _pending.size();
+    }
+
+    _pending.push_back(MapChange<K>(key, kind));
+}
+
+template<typename K, typename V, typename H>
+void ObservableMap<K, V, H>::publish()
+{
+    if (!ObservableBatch::active())
+    {
+        deliver();
+    }
+    else if (!_batched)
+    {
+        _batched = true;
+        ObservableBatch::defer(this);
+    }
+}
+
+template<typename K, typename V, typename H>
+void ObservableMap<K, V, H>::deliver()
+{
+    if (_pending.empty())
+        return;
+
+    Changes pending;
+    pending.swap(_pending);
+    if (!_pendingIndex.empty())
+        _pendingIndex.clear();
+
+    Propagation::Scope scope;
+
+    if (!_watchers.empty())
+    {
+        for (const MapChange<K>& change : pending)
+            notifyKey(change.key);
+    }
+
+    _changes.deliver(std::move(pending));
+}
+
+template<typename K, typename V, typename H>
+void ObservableMap<K, V, H>::notifyKey(const K& key)
+{
+    std::unique_ptr<Watchers> *found = _watchers.find(key);
+    if (!found)
+        return;
+
+    // Callbacks may watch or change keys, so the list is walked by index,
+    // and only the subscriptions present at the beginning are notified.
+    Watchers *list = found->get();
+    const std::size_t count = list->size();
+    bool dead = false;
+
+    ++_notifying;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (Subscription s = (*list)[i].lock())
+            static_cast<WatchNode *>(s.node())->callback(_entries.find(key));
+        else
+            dead = true;
+    }
+    --_notifying;
+
+    if (dead && (_notifying == 0))
+        prune(key);
+}
+
+template<typename K, typename V, typename H>
+void ObservableMap<K, V, H>::prune(const K& key)
+{
+    std::unique_ptr<Watchers> *found = _watchers.find(key);
+    if (!found)
+        return;
+
+    Watchers& list = **found;
+    dropExpired(list);
+
+    if (list.empty())
+        _watchers.erase(key);
+}
+
+#endif // OBSERVABLEMAP_H
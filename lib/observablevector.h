@@ -0,0 +1,289 @@
+#ifndef OBSERVABLEVECTOR_H
+#define OBSERVABLEVECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "changestream.h"
+#include "observable.h"
+
+/*!
+ * \brief A change record of an ObservableVector, describing a range of items.
+ */
+struct VectorChange
+{
+    enum Kind
+    {
+        Insert, /*!< count items were inserted at first. */
+        Remove, /*!< count items were removed from first. */
+        Move,   /*!< count items were moved from first, so that they start at to. */
+        Update, /*!< count items starting at first were replaced. */
+        Reset   /*!< The whole contents were replaced. */
+    };
+
+    Kind kind;
+    std::size_t first;
+    std::size_t count;
+    std::size_t to;
+
+    VectorChange(Kind k, std::size_t f = 0, std::size_t c = 0, std::size_t t = 0) :
+        kind(k), first(f), count(c), to(t) {}
+
+    bool operator==(const VectorChange& other) const
+    {
+        return (kind == other.kind) && (first == other.first)
+                && (count == other.count) && (to == other.to);
+    }
+
+    bool operator!=(const VectorChange& other) const { return !(*this == other); }
+};
+
+using VectorChanges = std::vector<VectorChange>;
+
+/*!
+ * \brief An observable list of items.
+ *
+ *        Besides the whole-value notifications of an Observable<std::vector<T>>,
+ *        whose callbacks get a reference to the items rather than a copy,
+ *        the vector reports what has changed as range-based records, see changes().
+ *        The records are applied in order, each one to the result of the previous ones.
+ *        Edits made within an ObservableBatch are delivered at once,
+ *        adjacent records of the same kind merged.
+ *
+ *        Out of range edits do nothing, insertion positions past the end append.
+ */
+template<typename T>
+class ObservableVector : public Observable<std::vector<T>>
+{
+public:
+    using Base = Observable<std::vector<T>>;
+    using Items = std::vector<T>;
+
+    ObservableVector(Items items = Items(), bool firesOnAddCallback = true) :
+        Base(firesOnAddCallback), _items(std::move(items))
+    {
+        // Change records are delivered along with the whole-value notification,
+        // so that batching and propagation treat both alike.
+        bool fires = this->firesOnAddCallback();
+        this->setFiresOnAddCallback(false);
+        _delivery = this->addCallback([this](const Items&) { this->deliverChanges(); });
+        this->setFiresOnAddCallback(fires);
+    }
+
+    ObservableVector(const ObservableVector&) = delete;
+    ObservableVector& operator=(const ObservableVector&) = delete;
+
+    /*!< A copy of the items, prefer items() to avoid copying. */
+    Items get() { return _items; }
+
+    const Items& items() const { return _items; }
+    std::size_t size() const { return _items.size(); }
+    bool empty() const { return _items.empty(); }
+    const T& at(std::size_t index) const { return _items[index]; }
+    const T& operator[](std::size_t index) const { return _items[index]; }
+
+    /*!< The change records. */
+    ChangeStream<VectorChanges>& changes() { return _changes; }
+
+    void insert(std::size_t index, T value);
+
+    template<typename It>
+    void insert(std::size_t index, It first, It last);
+
+    void append(T value) { insert(_items.size(), std::move(value)); }
+
+    void remove(std::size_t index, std::size_t count = 1);
+
+    /*!< Moves count items from index, so that they start at to in the resulting vector. */
+    void move(std::size_t index, std::size_t count, std::size_t to);
+
+    /*!< Replaces an item. An equal value is dropped according to the comparison policy. */
+    void update(std::size_t index, T value);
+
+    void clear();
+
+protected:
+    void doSet(Items&& items)
+    {
+        _items = std::move(items);
+        record(VectorChange(VectorChange::Reset));
+    }
+
+    const Items *stored() { return &_items; }
+
+private:
+    /*!< Adds a record to the pending change, merging it with the previous one if possible. */
+    void record(const VectorChange& change);
+
+    void deliverChanges()
+    {
+        if (_pending.empty())
+            return;
+
+        VectorChanges pending;
+        pending.swap(_pending);
+        _changes.deliver(std::move(pending));
+    }
+
+    Items _items;
+    VectorChanges _pending;
+    ChangeStream<VectorChanges> _changes;
+    Subscription _delivery;
+};
+
+template<typename T>
+void ObservableVector<T>::insert(std::size_t index, T value)
+{
+    index = std::min(index, _items.size());
+    _items.insert(_items.begin() + index, std::move(value));
+    record(VectorChange(VectorChange::Insert, index, 1));
+    this->changed();
+}
+
+template<typename T>
+template<typename It>
+void ObservableVector<T>::insert(std::size_t index, It first, It last)
+{
+    index = std::min(index, _items.size());
+    const std::size_t before = _items.size();
+    _items.insert(_items.begin() + index, first, last);
+
+    const std::size_t count = _items.size() - before;
+    if (count == 0)
+        return;
+
+    record(VectorChange(VectorChange::Insert, index, count));
+    this->changed();
+}
+
+template<typename T>
+void ObservableVector<T>::remove(std::size_t index, std::size_t count)
+{
+    if (index >= _items.size())
+        return;
+
+    count = std::min(count, _items.size() - index);
+    if (count == 0)
+        return;
+
+    _items.erase(_items.begin() + index, _items.begin() + index + count);
+    record(VectorChange(VectorChange::Remove, index, count));
+    this->changed();
+}
+
+template<typename T>
+void ObservableVector<T>::move(std::size_t index, std::size_t count, std::size_t to)
+{
+    const std::size_t size = _items.size();
+    if ((count == 0) || (index == to) || (index > size) || (count > size - index) || (to > size - count))
+        return;
+
+    auto begin = _items.begin();
+    if (to < index)
+        std::rotate(begin + to, begin + index, begin + index + count);
+    else
+        std::rotate(begin + index, begin + index + count, begin + to + count);
+
+    record(VectorChange(VectorChange::Move, index, count, to));
+    this->changed();
+}
+
+template<typename T>
+void ObservableVector<T>::update(std::size_t index, T value)
+{
+    if (index >= _items.size())
+        return;
+
+    // The whole-vector policy compares vectors, an item is simply compared with operator!=.
+    if (!(value != _items[index]) && (this->comparison() != Comparison::Always))
+        return;
+
+    _items[index] = std::move(value);
+    record(VectorChange(VectorChange::Update, index, 1));
+    this->changed();
+}
+
+template<typename T>
+void ObservableVector<T>::clear()
+{
+    if (_items.empty())
+        return;
+
+    const std::size_t count = _items.size();
+    _items.clear();
+    record(VectorChange(VectorChange::Remove, 0, count));
+    this->changed();
+}
+
+template<typename T>
+void ObservableVector<T>::record(const VectorChange& change)
+{
+    if (change.kind == VectorChange::Reset)
+    {
+        _pending.clear();
+        _pending.push_back(change);
+        return;
+    }
+
+    if (_pending.empty())
+    {
+        _pending.push_back(change);
+        return;
+    }
+
+    VectorChange& last = _pending.back();
+
+    // A pending reset makes the consumers reload everything anyway.
+    if (last.kind == VectorChange::Reset)
+        return;
+
+    if (last.kind == change.kind)
+    {
+        switch (change.kind)
+        {
+        case VectorChange::Insert:
+            // E.g. appending in a loop.
+            if ((change.first >= last.first) && (change.first <= last.first + last.count))
+            {
+                last.count += change.count;
+                return;
+            }
+            break;
+
+        case VectorChange::Remove:
+            // Removing at the same position repeatedly, or moving backwards.
+            if (change.first == last.first)
+            {
+                last.count += change.count;
+                return;
+            }
+
+            if (change.first + change.count == last.first)
+            {
+                last.first = change.first;
+                last.count += change.count;
+                return;
+            }
+            break;
+
+        case VectorChange::Update:
+            // Overlapping or adjacent ranges are merged into one.
+            if ((change.first <= last.first + last.count) && (last.first <= change.first + change.count))
+            {
+                const std::size_t end = std::max(last.first + last.count, change.first + change.count);
+                last.first = std::min(last.first, change.first);
+                last.count = end - last.first;
+                return;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    _pending.push_back(change);
+}
+
+#endif // OBSERVABLEVECTOR_H
@@ -0,0 +1,228 @@
+#ifndef PROPAGATION_H
+#define PROPAGATION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/*!
+ * \brief A node of the derived value graph, e.g. a ComputedObservable.
+ *        A node's height is greater than the heights of all the nodes it depends on,
+ *        plain observables being at height 0.
+ */
+class PropagationNode
+{
+public:
+    PropagationNode() : _height(0), _queued(false) {}
+
+    unsigned height() const { return _height; }
+
+    /*!< Marks the node and everything that depends on it out of date. */
+    virtual void invalidate() = 0;
+
+protected:
+    virtual ~PropagationNode();
+
+    /*!< Brings the node up to date and notifies its callbacks. */
+    virtual void propagate() = 0;
+
+    void setHeight(unsigned height) { _height = height; }
+
+    /*!
+     * \brief Makes the node depend on another one:
+     *        invalidating the upstream node invalidates this one as well.
+     */
+    void dependOn(PropagationNode *upstream)
+    {
+        _height = std::max(_height, upstream->_height + 1);
+        upstream->_dependents.push_back(this);
+        _upstream.push_back(upstream);
+    }
+
+    void invalidateDependents()
+    {
+        for (PropagationNode *dependent : _dependents)
+            dependent->invalidate();
+    }
+
+    /*!< Queues the node for propagation. Does nothing if it is queued already. */
+    void schedule();
+
+private:
+    friend class Propagation;
+
+    unsigned _height;
+    bool _queued;
+    std::vector<PropagationNode *> _dependents;
+    std::vector<PropagationNode *> _upstream;
+};
+
+/*!
+ * \brief The per-thread propagation queue.
+ *        Observables open a Scope while notifying their callbacks.
+ *        Nodes scheduled meanwhile are propagated once the outermost scope closes,
+ *        lowest height first, so that in a diamond-shaped graph
+ *        a node is only brought up to date after all of its inputs,
+ *        and at most once per upstream change.
+ *
+ *        The outermost scope also starts a new update epoch,
+ *        which lets e.g. a widget binding recognize the echo of its own change.
+ *        Cycles of bindings are broken by the observables themselves:
+ *        a binding does not write into an observable the update has come through,
+ *        see Observable::visited().
+ */
+class Propagation
+{
+public:
+    /*!< An RAII marker of a running notification. */
+    class Scope
+    {
+    public:
+        Scope()
+        {
+            State& s = state();
+            if (s.depth++ == 0)
+                ++s.epoch;
+        }
+
+        ~Scope()
+        {
+            if (--state().depth == 0)
+                drain();
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    /*!< Whether an update is running, i.e. a scope is open. */
+    static bool active() { return state().depth > 0; }
+
+    /*!< The current update epoch. Epochs start at 1, so 0 never matches a running update. */
+    static std::uint64_t epoch() { return state().epoch; }
+
+    /*!< Whether a stamp was taken during the running update. */
+    static bool current(std::uint64_t stamp)
+    {
+        const State& s = state();
+        return (s.depth > 0) && (stamp == s.epoch);
+    }
+
+    /*!
+     * \brief Starts a new epoch within the running update.
+     *        Used when an observable the update has already come through is set again,
+     *        see Observable::visited().
+     */
+    static void restart() { ++state().epoch; }
+
+    /*!
+     * \brief The number of binding conversions performed on this thread,
+     *        i.e. calls of bind() and bindTwoWay() convert/revert functors.
+     *        Take the difference of two readings to measure an update.
+     */
+    static std::uint64_t conversions() { return state().conversions; }
+    static void countConversion() { ++state().conversions; }
+
+    static void schedule(PropagationNode *node)
+    {
+        if (node->_queued)
+            return;
+
+        node->_queued = true;
+
+        State& s = state();
+        s.queue.push_back(Entry(node->_height, s.order++, node));
+        std::push_heap(s.queue.begin(), s.queue.end());
+
+        if (s.depth == 0)
+            drain();
+    }
+
+    /*!< Removes a node from the queue, e.g. when it is destroyed. */
+    static void cancel(PropagationNode *node)
+    {
+        for (Entry& e : state().queue)
+        {
+            if (e.node == node)
+                e.node = nullptr;
+        }
+
+        node->_queued = false;
+    }
+
+private:
+    struct Entry
+    {
+        unsigned height;
+        std::uint64_t order;
+        PropagationNode *node;
+
+        Entry(unsigned h, std::uint64_t o, PropagationNode *n) : height(h), order(o), node(n) {}
+
+        // std::push_heap builds a max-heap, so the lowest (height, order) must compare greatest.
+        bool operator<(const Entry& other) const
+        {
+            return (height != other.height) ? (height > other.height) : (order > other.order);
+        }
+    };
+
+    struct State
+    {
+        unsigned depth = 0;
+        bool draining = false;
+        std::uint64_t order = 0;
+        std::uint64_t epoch = 0;
+        std::uint64_t conversions = 0;
+        std::vector<Entry> queue;
+    };
+
+    static State& state()
+    {
+        static thread_local State s;
+        return s;
+    }
+
+    static void drain()
+    {
+        State& s = state();
+        if (s.draining)
+            return;
+
+        // Nodes propagated here notify their dependents, which get queued in turn
+        // and are handled by this very loop.
+        s.draining = true;
+        while (!s.queue.empty())
+        {
+            std::pop_heap(s.queue.begin(), s.queue.end());
+            PropagationNode *node = s.queue.back().node;
+            s.queue.pop_back();
+
+            if (node)
+            {
+                node->_queued = false;
+                node->propagate();
+            }
+        }
+
+        s.draining = false;
+    }
+};
+
+inline PropagationNode::~PropagationNode()
+{
+    if (_queued)
+        Propagation::cancel(this);
+
+    for (PropagationNode *upstream : _upstream)
+    {
+        std::vector<PropagationNode *>& d = upstream->_dependents;
+        d.erase(std::remove(d.begin(), d.end(), this), d.end());
+    }
+}
+
+inline void PropagationNode::schedule()
+{
+    Propagation::schedule(this);
+}
+
+#endif // PROPAGATION_H
@@ -0,0 +1,120 @@
+#ifndef QUEUEDDELIVERY_H
+#define QUEUEDDELIVERY_H
+
+#include <QObject>
+#include <QPointer>
+#include <QMetaObject>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "notificationscheduler.h"
+
+/*!
+ * \brief A callback wrapper that delivers values on the thread of a context QObject.
+ *        It may be invoked from any thread, e.g. as a ConcurrentObservable callback.
+ *        Instead of queueing every value, it keeps the latest one and posts a single
+ *        queued invocation: all the values produced before the context's event loop
+ *        gets to it are coalesced into one delivery of the latest value.
+ *
+ *        As with any other callback, the wrapped block is not called
+ *        once the subscription handle is gone. The context object must outlive the subscription.
+ *        Use deliverOn() to create one.
+ */
+template<typename T, typename F>
+class QueuedDelivery
+{
+public:
+    QueuedDelivery(QObject *context, F block) :
+        _state(std::make_shared<State>(context, std::move(block))) {}
+
+    void operator()(const T& value) const
+    {
+        bool post = false;
+        {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            if (_state->latest)
+                *_state->latest = value;
+            else
+                _state->latest.reset(new T(value));
+
+            post = !_state->pending;
+            _state->pending = true;
+        }
+
+        if (!post)
+            return;
+
+        // The queued invocation holds a weak reference only,
+        // so a delivery is dropped if the subscription died in the meantime.
+        std::weak_ptr<State> weak = _state;
+        QMetaObject::invokeMethod(_state->context, [weak]()
+        {
+            if (std::shared_ptr<State> state = weak.lock())
+                state->deliver();
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    struct State
+    {
+        State(QObject *c, F b) : context(c), block(std::move(b)), pending(false) {}
+
+        void deliver()
+        {
+            // The two buffers swap roles,
+            // so that the steady state does not allocate and the block runs unlocked.
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending = false;
+                std::swap(latest, delivering);
+            }
+
+            if (delivering && guard)
+                block(*delivering);
+        }
+
+        QObject *context;
+        QPointer<QObject> guard { context };
+        F block;
+
+        std::mutex mutex;
+        std::unique_ptr<T> latest;
+        std::unique_ptr<T> delivering;
+        bool pending;
+    };
+
+    std::shared_ptr<State> _state;
+};
+
+/*!
+ * \brief Wraps a callback so that it runs on the context object's thread
+ *        with coalesced, latest-value delivery, e.g.
+ *
+ *        _handle = worker.addCallback(deliverOn<std::string>(this,
+ *            [this](const std::string& v) { vm->text().set(v); }));
+ */
+template<typename T, typename F>
+QueuedDelivery<T, F> deliverOn(QObject *context, F block)
+{
+    return QueuedDelivery<T, F>(context, std::move(block));
+}
+
+/*!
+ * \brief Makes the event loop of the context object's thread run a NotificationScheduler:
+ *        the changes queued meanwhile are dispatched by a single queued invocation.
+ *        The scheduler must live as long as the event loop runs, e.g.
+ *
+ *        NotificationScheduler scheduler;
+ *        driveFromEventLoop(scheduler, &app);
+ *        scheduler.install();
+ */
+inline void driveFromEventLoop(NotificationScheduler& scheduler, QObject *context)
+{
+    NotificationScheduler *pScheduler = &scheduler;
+    scheduler.setWakeup([pScheduler, context]()
+    {
+        QMetaObject::invokeMethod(context, [pScheduler]() { pScheduler->run(); }, Qt::QueuedConnection);
+    });
+}
+
+#endif // QUEUEDDELIVERY_H
@@ -0,0 +1,97 @@
+#ifndef SHAREDVALUEOBSERVABLE_H
+#define SHAREDVALUEOBSERVABLE_H
+
+#include <memory>
+#include <utility>
+#include "observable.h"
+
+/*!
+ * \brief An observable that stores its value as an immutable shared snapshot,
+ *        for large values read more often than written.
+ *
+ *        snapshot() hands out the current value in O(1), and the snapshot stays intact
+ *        however the observable changes later. Callbacks receive a reference to the snapshot
+ *        being notified of, and may keep it by calling snapshot().
+ *        A set() writes into the current snapshot in place if nobody else shares it,
+ *        and allocates a new one otherwise.
+ *        setSnapshot() adopts a snapshot made elsewhere, e.g. by another observable,
+ *        without copying the value.
+ */
+template<typename T>
+class SharedValueObservable : public Observable<T>
+{
+public:
+    using Snapshot = std::shared_ptr<const T>;
+
+    SharedValueObservable(T value, bool firesOnAddCallback = true) :
+        Observable<T>(firesOnAddCallback), _value(std::make_shared<T>(std::move(value))), _exclusive(true) {}
+
+    /*!< A copy of the value, prefer snapshot() or value() for large values. */
+    T get() { return *_value; }
+
+    Snapshot snapshot() const { return _value; }
+
+    const T& value() const { return *_value; }
+
+    /*!< Replaces the value with a shared snapshot, notifying the callbacks if it differs. */
+    void setSnapshot(Snapshot snapshot);
+
+    /*!< Sets the value without notifying the callbacks, see ValueObservable::assign(). */
+    void assign(const T& value)
+    {
+        replace(T(value));
+        this->touch();
+    }
+
+    void assign(T&& value)
+    {
+        replace(std::move(value));
+        this->touch();
+    }
+
+    void assign(Snapshot snapshot)
+    {
+        if (!snapshot)
+            return;
+
+        _value = std::move(snapshot);
+        _exclusive = false;
+        this->touch();
+    }
+
+protected:
+    void doSet(T&& value) { replace(std::move(value)); }
+    const T *stored() { return _value.get(); }
+
+private:
+    void replace(T&& value)
+    {
+        // A snapshot handed out, or adopted, must stay intact.
+        if (_exclusive && (_value.use_count() == 1))
+        {
+            const_cast<T&>(*_value) = std::move(value);
+            return;
+        }
+
+        _value = std::make_shared<T>(std::move(value));
+        _exclusive = true;
+    }
+
+    Snapshot _value;
+
+    /*!< Whether the snapshot was allocated by this observable, and so may be written to. */
+    bool _exclusive;
+};
+
+template<typename T>
+void SharedValueObservable<T>::setSnapshot(Snapshot snapshot)
+{
+    if (!snapshot || (snapshot == _value) || this->unchanged(*snapshot, _value.get()))
+        return;
+
+    _value = std::move(snapshot);
+    _exclusive = false;
+    this->changed();
+}
+
+#endif // SHAREDVALUEOBSERVABLE_H
@@ -7,21 +7,13 @@ struct Size
     int y;
 
     Size(int x, int y) : x(x), y(y) {}
-    Size(const Size& other) : Size(other.x, other.y) {}
 
-    Size& operator=(const Size& other)
-    {
-        x = other.x;
-        y = other.y;
-        return *this;
-    }
-
-    bool operator==(const Size& other)
+    bool operator==(const Size& other) const
     {
         return (x == other.x) && (y == other.y);
     }
 
-    bool operator!=(const Size& other)
+    bool operator!=(const Size& other) const
     {
         return !(*this == other);
     }
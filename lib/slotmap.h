@@ -0,0 +1,193 @@
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*!
+ * \brief A generational key of a SlotMap element.
+ *        A key becomes stale once its element is erased,
+ *        even if the slot gets reused later.
+ */
+struct SlotKey
+{
+    std::uint32_t index;
+    std::uint32_t generation;
+
+    SlotKey() : index(UINT32_MAX), generation(0) {}
+    SlotKey(std::uint32_t i, std::uint32_t g) : index(i), generation(g) {}
+};
+
+/*!
+ * \brief A vector of slots with O(1) insertion, lookup and erasure.
+ *        Vacant slots are chained into an intrusive free list,
+ *        so once the map has grown to its working size it stops allocating.
+ *        Elements never move between slots,
+ *        so the map may be iterated by slot index while being modified.
+ *        The value type must be default constructible and movable.
+ *        The slots are allocated with A, rebound to the slot type.
+ */
+template<typename V, typename A = std::allocator<V>>
+class SlotMap
+{
+public:
+    explicit SlotMap(const A& allocator = A()) : _slots(SlotAllocator(allocator)), _size(0), _free(noSlot), _generation(0) {}
+
+    /*!< Inserts a value, reusing a vacant slot if there is one. */
+    SlotKey insert(V value)
+    {
+        if (_free == noSlot)
+            return append(std::move(value));
+
+        std::uint32_t index = _free;
+        Slot& slot = _slots[index];
+        _free = slot.nextFree;
+        slot.value = std::move(value);
+        slot.occupied = true;
+        ++_size;
+        return SlotKey(index, slot.generation);
+    }
+
+    /*!
+     * \brief Inserts a value into a new slot at the end.
+     *        Unlike insert(), never fills a slot that lies before the end,
+     *        so a running iteration either reaches the value as the last one, or not at all.
+     */
+    SlotKey append(V value)
+    {
+        Slot slot;
+        slot.value = std::move(value);
+        slot.generation = _generation;
+        slot.nextFree = noSlot;
+        slot.occupied = true;
+        _slots.push_back(std::move(slot));
+        ++_size;
+        return SlotKey(std::uint32_t(_slots.size() - 1), _generation);
+    }
+
+    /*!< Returns the value by key, or nullptr if the key is stale. */
+    V *find(SlotKey key)
+    {
+        if (key.index >= _slots.size())
+            return nullptr;
+
+        Slot& slot = _slots[key.index];
+        return (slot.occupied && (slot.generation == key.generation)) ? &slot.value : nullptr;
+    }
+
+    /*!< Erases a value by key. Returns false if the key is stale. */
+    bool erase(SlotKey key)
+    {
+        if (!find(key))
+            return false;
+
+        eraseAt(key.index);
+        return true;
+    }
+
+    /*!< Number of slots, occupied or not. Valid indices are [0, slotCount()). */
+    std::size_t slotCount() const { return _slots.size(); }
+
+    /*!< Returns the value in a slot, or nullptr if the slot is vacant. */
+    V *at(std::size_t index)
+    {
+        Slot& slot = _slots[index];
+        return slot.occupied ? &slot.value : nullptr;
+    }
+
+    /*!< Erases the value in an occupied slot. */
+    void eraseAt(std::size_t index)
+    {
+        Slot& slot = _slots[index];
+        // The value is destroyed only after the slot is consistent again,
+        // as its destructor may in turn modify the map.
+        V erased(std::move(slot.value));
+        slot.value = V();
+        slot.occupied = false;
+        ++slot.generation;
+        slot.nextFree = _free;
+        _free = std::uint32_t(index);
+        --_size;
+    }
+
+    /*!< Number of occupied slots. */
+    std::size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    void clear()
+    {
+        for (const Slot& slot : _slots)
+            retire(slot);
+
+        // Moving the slots out first lets element destructors safely touch the map.
+        Slots slots(_slots.get_allocator());
+        slots.swap(_slots);
+        _size = 0;
+        _free = noSlot;
+    }
+
+    /*!
+     * \brief Releases the vacant slots at the end and the spare capacity.
+     *        The remaining elements keep their slots and keys.
+     *        Must not be called while the map is being iterated by slot index.
+     */
+    void shrink()
+    {
+        while (!_slots.empty() && !_slots.back().occupied)
+        {
+            retire(_slots.back());
+            _slots.pop_back();
+        }
+
+        // Relink the vacant slots left, lowest index first.
+        _free = noSlot;
+        for (std::size_t i = _slots.size(); i-- > 0;)
+        {
+            if (!_slots[i].occupied)
+            {
+                _slots[i].nextFree = _free;
+                _free = std::uint32_t(i);
+            }
+        }
+
+        _slots.shrink_to_fit();
+    }
+
+    /*!< The memory taken by the slots, the spare capacity included. */
+    std::size_t bytes() const { return _slots.capacity() * sizeof(Slot); }
+
+private:
+    static const std::uint32_t noSlot = UINT32_MAX;
+
+    struct Slot
+    {
+        V value;
+        std::uint32_t generation;
+        std::uint32_t nextFree;
+        bool occupied;
+    };
+
+    using SlotAllocator = typename std::allocator_traits<A>::template rebind_alloc<Slot>;
+    using Slots = std::vector<Slot, SlotAllocator>;
+
+    /*!
+     * \brief Accounts for a slot about to be dropped,
+     *        so that a slot appended at its index later does not match the keys issued for it.
+     */
+    void retire(const Slot& slot)
+    {
+        const std::uint32_t next = slot.occupied ? slot.generation + 1 : slot.generation;
+        if (next > _generation)
+            _generation = next;
+    }
+
+    Slots _slots;
+    std::size_t _size;
+    std::uint32_t _free;
+
+    /*!< The generation of new slots at the end, above that of any slot dropped before. */
+    std::uint32_t _generation;
+};
+
+#endif // SLOTMAP_H
@@ -0,0 +1,127 @@
+#ifndef STATICBINDING_H
+#define STATICBINDING_H
+
+#include <QObject>
+#include "observable.h"
+#include "propagation.h"
+
+/*!
+ * \brief A widget property whose accessors are known at compile time, e.g.
+ *
+ *        using EditText = Property<QLineEdit, QString, &QLineEdit::text, &QLineEdit::setText>;
+ *
+ *        The accessors are template arguments, so calls through the property are inlined.
+ */
+template<typename W, typename V, V (W::*getter)() const, void (W::*setter)(const V&)>
+struct Property
+{
+    using Widget = W;
+    using Value = V;
+
+    static V get(const W& widget) { return (widget.*getter)(); }
+    static void set(W& widget, const V& value) { (widget.*setter)(value); }
+};
+
+/*!< The revert type of a one-way StaticBinding. */
+struct NoRevert {};
+
+/*!
+ * \brief A binding of an observable to a widget property, declared statically by a view:
+ *
+ *        StaticBinding<std::string, LabelText, StdToQString> _captionBinding;
+ *        StaticBinding<std::string, EditText, StdToQString, QStringToStd> _inputBinding;
+ *
+ *        _captionBinding.bind(vm->caption(), _captionLabel);
+ *        _inputBinding.bind(vm->text(), _input, &QLineEdit::textChanged);
+ *
+ *        The property accessors, the conversions and the comparison are types,
+ *        so an update takes a single indirect call, the observable's callback,
+ *        instead of the type-erased getter, setter and virtual calls of a UIBinding.
+ *        The conversions are default constructed function objects.
+ *
+ *        Like the dynamic bindings, the binding never writes back into the side
+ *        the update has come through, so the widget's echo of a change
+ *        is not written into the observable. A source reached along several paths
+ *        takes the write of each, and each changed value reaches the widget.
+ *        Unlike UIBinding, the widget side is not an observable of its own,
+ *        so it has no update policy and no subscribers besides the binding.
+ *        The observable and the widget must outlive the binding, or its unbind().
+ */
+template<typename T, typename P, typename Convert, typename Revert = NoRevert>
+class StaticBinding
+{
+public:
+    using Widget = typename P::Widget;
+    using Value = typename P::Value;
+
+    StaticBinding() : _source(nullptr), _widget(nullptr), _writing(false) {}
+
+    StaticBinding(const StaticBinding&) = delete;
+    StaticBinding& operator=(const StaticBinding&) = delete;
+
+    ~StaticBinding() { unbind(); }
+
+    /*!< Binds the widget one way. The widget is updated immediately. */
+    void bind(Observable<T>& source, Widget *widget)
+    {
+        unbind();
+        _source = &source;
+        _widget = widget;
+        _subscription = source.addCallback([this](const T& value) { this->push(value); });
+    }
+
+    /*!< Binds the widget both ways: its signal carrying the new value writes the observable back. */
+    template<typename O, typename A>
+    void bind(Observable<T>& source, Widget *widget, O *sender, void (O::*signal)(A))
+    {
+        bind(source, widget);
+        _connection = QObject::connect(sender, signal, [this](A value) { this->pull(value); });
+    }
+
+    void unbind()
+    {
+        QObject::disconnect(_connection);
+        _subscription = nullptr;
+        _source = nullptr;
+        _widget = nullptr;
+    }
+
+private:
+    void push(const T& value)
+    {
+        // The update came from the widget.
+        if (_writing)
+            return;
+
+        Propagation::countConversion();
+        Value converted = Convert()(value);
+        if (!(P::get(*_widget) != converted))
+            return;
+
+        // The signal the widget emits meanwhile is the echo of this change.
+        _writing = true;
+        P::set(*_widget, converted);
+        _writing = false;
+    }
+
+    void pull(const Value& value)
+    {
+        if (_writing || _source->visited())
+            return;
+
+        Propagation::countConversion();
+        _writing = true;
+        _source->set(Revert()(value));
+        _writing = false;
+    }
+
+    Observable<T> *_source;
+    Widget *_widget;
+    Subscription _subscription;
+    QMetaObject::Connection _connection;
+
+    /*!< Set while the binding writes into either side, so that it ignores the echo. */
+    bool _writing;
+};
+
+#endif // STATICBINDING_H
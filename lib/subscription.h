@@ -0,0 +1,193 @@
+#ifndef SUBSCRIPTION_H
+#define SUBSCRIPTION_H
+
+#include <cstddef>
+#include <utility>
+#include "slotmap.h"
+
+/*!
+ * \brief A node of an intrusively reference counted subscription.
+ *        Subscription handles hold strong references,
+ *        the observable holds a weak one.
+ *        The subscribed callback is disposed of as soon as the last strong reference is gone,
+ *        while the node itself lives until the last reference of any kind is released.
+ *        The counters are not atomic, like the observables themselves.
+ */
+class SubscriptionNode
+{
+public:
+    SubscriptionNode() : _strong(0), _weak(0), _detached(false) {}
+
+    /*!< Whether the subscribed callback is still alive. */
+    bool alive() const { return _strong > 0; }
+
+    /*!
+     * \brief Whether the owning observable is gone, so the callback will never run again.
+     *        A binding kept in another observable's list may then be dropped.
+     */
+    bool detached() const { return _detached; }
+
+    /*!< Called by the owning observable when it is destroyed. */
+    void detach() { _detached = true; }
+
+    /*!< The size of the node, the inline callback included. */
+    virtual std::size_t bytes() const { return sizeof(SubscriptionNode); }
+
+    /*!< The heap memory taken by the callback's captures, if they did not fit inline. */
+    virtual std::size_t captureBytes() const { return 0; }
+
+    /*!< The node's position in the owning observable's callback list. */
+    SlotKey slot;
+
+protected:
+    /*!< Destroys the subscribed callback. Called when the last strong reference is released. */
+    virtual void dispose() = 0;
+
+    /*!< Frees the node. Nodes not allocated with plain new, e.g. in an arena, override it. */
+    virtual void destroy() { delete this; }
+
+    virtual ~SubscriptionNode() {}
+
+private:
+    friend class Subscription;
+    friend class WeakSubscription;
+
+    void retain() { ++_strong; }
+
+    void release()
+    {
+        if (--_strong > 0)
+            return;
+
+        // Keep the node while disposing,
+        // as the callback may hold the last handle to another subscription.
+        ++_weak;
+        dispose();
+        releaseWeak();
+    }
+
+    void retainWeak() { ++_weak; }
+
+    void releaseWeak()
+    {
+        if ((--_weak == 0) && (_strong == 0))
+            destroy();
+    }
+
+    unsigned _strong;
+    unsigned _weak;
+    bool _detached;
+};
+
+/*!
+ * \brief A strong subscription handle.
+ *        The subscribed callback lives as long as any copy of the handle does.
+ */
+class Subscription
+{
+public:
+    Subscription() : _node(nullptr) {}
+    Subscription(std::nullptr_t) : _node(nullptr) {}
+
+    /*!< Takes a (possibly fresh) node under control. */
+    explicit Subscription(SubscriptionNode *node) : _node(node)
+    {
+        if (_node)
+            _node->retain();
+    }
+
+    Subscription(const Subscription& other) : Subscription(other._node) {}
+
+    Subscription(Subscription&& other) : _node(other._node)
+    {
+        other._node = nullptr;
+    }
+
+    Subscription& operator=(Subscription other)
+    {
+        std::swap(_node, other._node);
+        return *this;
+    }
+
+    ~Subscription() { reset(); }
+
+    void reset()
+    {
+        if (_node)
+        {
+            SubscriptionNode *node = _node;
+            _node = nullptr;
+            node->release();
+        }
+    }
+
+    SubscriptionNode *node() const { return _node; }
+
+    explicit operator bool() const { return _node != nullptr; }
+
+    bool operator==(const Subscription& other) const { return _node == other._node; }
+    bool operator!=(const Subscription& other) const { return _node != other._node; }
+
+private:
+    SubscriptionNode *_node;
+};
+
+/*!
+ * \brief A weak subscription handle.
+ *        It does not keep the callback alive, but may be locked to obtain a strong handle.
+ */
+class WeakSubscription
+{
+public:
+    WeakSubscription() : _node(nullptr) {}
+
+    WeakSubscription(const Subscription& strong) : _node(strong.node())
+    {
+        if (_node)
+            _node->retainWeak();
+    }
+
+    WeakSubscription(const WeakSubscription& other) : _node(other._node)
+    {
+        if (_node)
+            _node->retainWeak();
+    }
+
+    WeakSubscription(WeakSubscription&& other) : _node(other._node)
+    {
+        other._node = nullptr;
+    }
+
+    WeakSubscription& operator=(WeakSubscription other)
+    {
+        std::swap(_node, other._node);
+        return *this;
+    }
+
+    ~WeakSubscription() { reset(); }
+
+    void reset()
+    {
+        if (_node)
+        {
+            SubscriptionNode *node = _node;
+            _node = nullptr;
+            node->releaseWeak();
+        }
+    }
+
+    bool expired() const { return !_node || !_node->alive(); }
+
+    /*!< Returns a strong handle, or a null one if the callback is already gone. */
+    Subscription lock() const
+    {
+        return expired() ? Subscription() : Subscription(_node);
+    }
+
+    SubscriptionNode *node() const { return _node; }
+
+private:
+    SubscriptionNode *_node;
+};
+
+#endif // SUBSCRIPTION_H
@@ -0,0 +1,95 @@
+#ifndef SYNCGROUP_H
+#define SYNCGROUP_H
+
+#include <algorithm>
+#include <vector>
+#include "observable.h"
+
+/*!
+ * \brief Keeps any number of observables of the same type synchronized.
+ *        A change of one member is written into every other member once,
+ *        which takes one subscription per member instead of
+ *        a two-way binding between every pair of them.
+ *        The group may be combined with other bindings of its members:
+ *        bindings never write back into an observable the update has passed through,
+ *        and a member reached along several paths takes each path's write,
+ *        see Observable::visited().
+ *        Members must outlive the group or be removed from it.
+ */
+template<typename T>
+class SyncGroup
+{
+public:
+    SyncGroup() {}
+
+    SyncGroup(const SyncGroup&) = delete;
+    SyncGroup& operator=(const SyncGroup&) = delete;
+
+    /*!
+     * \brief Adds a member to the group.
+     *        The first member defines the group's value, the others take it upon adding.
+     */
+    void add(Observable<T>& member);
+
+    /*!< Removes a member from the group. Does nothing if it is not a member. */
+    void remove(Observable<T>& member);
+
+    std::size_t size() const { return _members.size(); }
+private:
+    struct Member
+    {
+        Observable<T> *observable;
+        typename Observable<T>::CallbackPtr subscription;
+    };
+
+    void changed(Observable<T> *source, const T& value);
+
+    std::vector<Member> _members;
+};
+
+template<typename T>
+void SyncGroup<T>::add(Observable<T>& member)
+{
+    if (!_members.empty())
+        member.set(_members.front().observable->get());
+
+    Observable<T> *source = &member;
+    _members.push_back(Member { source, nullptr });
+
+    // Added last, so that the initial call finds the member in the list, and finds it in sync.
+    typename Observable<T>::CallbackPtr subscription =
+            member.addCallback([this, source](const T& value) { this->changed(source, value); });
+
+    for (Member& m : _members)
+    {
+        if (m.observable == source)
+            m.subscription = subscription;
+    }
+}
+
+template<typename T>
+void SyncGroup<T>::remove(Observable<T>& member)
+{
+    auto it = std::find_if(_members.begin(), _members.end(),
+                           [&member](const Member& m) { return m.observable == &member; });
+
+    if (it == _members.end())
+        return;
+
+    member.removeCallback(it->subscription);
+    _members.erase(it);
+}
+
+template<typename T>
+void SyncGroup<T>::changed(Observable<T> *source, const T& value)
+{
+    // Members may be added or removed by the updates themselves, hence the index.
+    for (std::size_t i = 0; i < _members.size(); ++i)
+    {
+        Observable<T> *target = _members[i].observable;
+        if ((target != source) && !target->visited())
+            target->set(value);
+    }
+}
+
+#endif // SYNCGROUP_H
@@ -0,0 +1,110 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*!
+ * \brief A fixed set of worker threads running the submitted tasks in order of submission.
+ *        Destroying the pool drops the tasks that have not started yet
+ *        and waits for the running ones.
+ */
+class ThreadPool
+{
+public:
+    /*!< Starts the workers, as many as the hardware runs concurrently if threads is 0. */
+    explicit ThreadPool(unsigned threads = 0) : _stopping(false)
+    {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+
+        _threads.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i)
+            _threads.emplace_back([this]() { run(); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+            _queue.clear();
+        }
+
+        _wake.notify_all();
+        for (std::thread& thread : _threads)
+            thread.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /*!< A pool shared by the whole process, created on first use. */
+    static ThreadPool& shared()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    /*!
+     * \brief Queues a task. The future receives its result, or the exception it has thrown.
+     *        Unlike the one of std::async, the future does not wait for the task when destroyed.
+     */
+    template<typename F>
+    std::future<typename std::result_of<F ()>::type> submit(F task);
+
+    std::size_t threadCount() const { return _threads.size(); }
+
+private:
+    void run()
+    {
+        for (;;)
+        {
+            std::function<void ()> task;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [this]() { return _stopping || !_queue.empty(); });
+                if (_stopping)
+                    return;
+
+                task = std::move(_queue.front());
+                _queue.pop_front();
+            }
+
+            task();
+        }
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::deque<std::function<void ()>> _queue;
+    std::vector<std::thread> _threads;
+    bool _stopping;
+};
+
+template<typename F>
+std::future<typename std::result_of<F ()>::type> ThreadPool::submit(F task)
+{
+    using R = typename std::result_of<F ()>::type;
+
+    // std::function needs a copyable target, the task is not.
+    std::shared_ptr<std::packaged_task<R ()>> packaged = std::make_shared<std::packaged_task<R ()>>(std::move(task));
+    std::future<R> result = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.emplace_back([packaged]() { (*packaged)(); });
+    }
+
+    _wake.notify_one();
+    return result;
+}
+
+#endif // THREADPOOL_H
@@ -2,11 +2,24 @@
 #define UIBINDING_H
 
 #include <QObject>
+#include <QTimer>
+#include <memory>
 #include "aliasobservable.h"
 
 /*!
  * \brief An observable that represents a value in the Qt UI,
  *        e.g. a text field's value.
+ *
+ *        By default every change signal of the widget is propagated immediately.
+ *        For high-rate input, e.g. typing into a large text model,
+ *        the update policy may delay and coalesce the propagation:
+ *         - Debounce: propagate the latest value once the widget has been quiet for the interval;
+ *         - Throttle: propagate at most once per interval, the first and the latest value;
+ *         - OnCommit: propagate only when the commit signal fires, see commitOn().
+ *        Delayed updates are driven by the Qt event loop of the binding's thread.
+ *
+ *        Change signals the widget emits while an update has already visited the binding,
+ *        e.g. the echo of the binding's own set(), are ignored.
  */
 template<typename T>
 class UIBinding : public AliasObservable<T>
@@ -16,40 +29,150 @@ public:
     using Getter = typename Base::Getter;
     using Setter = typename Base::Setter;
 
+    enum class UpdatePolicy { Immediate, Debounce, Throttle, OnCommit };
+
     template<typename G, typename S, typename O, typename A>
     UIBinding(G get, S set, O* sender, void (O::*signal)(A)) :
         Base(get, set),
-        _locked(false)
+        _policy(UpdatePolicy::Immediate)
     {
         _connection = QObject::connect(sender, signal,
                                        [this](A value) {
-                                           if (!_locked)
-                                               this->onChange(value);
+                                           if (!this->visited())
+                                               this->widgetChanged(value);
                                        });
+
+        _timer.setSingleShot(true);
+        _timerConnection = QObject::connect(&_timer, &QTimer::timeout,
+                                            [this]() { this->timerFired(); });
     }
 
     virtual void set(T value);
 
+    /*!
+     * \brief Sets the update policy.
+     * \param msec - the debounce or throttle interval, ignored by the other policies.
+     *        Switching the policy propagates a pending value, if any.
+     */
+    void setUpdatePolicy(UpdatePolicy policy, int msec = 0);
+
+    UpdatePolicy updatePolicy() const { return _policy; }
+
+    /*!
+     * \brief Switches to the OnCommit policy, e.g. commitOn(edit, &QLineEdit::editingFinished).
+     */
+    template<typename O>
+    void commitOn(O* sender, void (O::*signal)())
+    {
+        setUpdatePolicy(UpdatePolicy::OnCommit);
+        QObject::disconnect(_commitConnection);
+        _commitConnection = QObject::connect(sender, signal, [this]() { this->flush(); });
+    }
+
+    /*!< Propagates the pending widget value right away, if there is one. */
+    void flush();
+
+    /*!< Whether a widget change is waiting to be propagated. */
+    bool hasPending() const { return _pending != nullptr; }
+
     virtual ~UIBinding()
     {
         QObject::disconnect(_connection);
+        QObject::disconnect(_timerConnection);
+        QObject::disconnect(_commitConnection);
     }
 private:
+    void widgetChanged(const T& value);
+    void timerFired();
+
+    /*!< Keeps a widget value to be propagated later, reusing the buffer. */
+    void hold(const T& value)
+    {
+        if (_pending)
+            *_pending = value;
+        else
+            _pending.reset(new T(value));
+    }
+
     QMetaObject::Connection _connection;
-    bool _locked;
+
+    UpdatePolicy _policy;
+    QTimer _timer;
+    QMetaObject::Connection _timerConnection;
+    QMetaObject::Connection _commitConnection;
+    std::unique_ptr<T> _pending;
 };
 
 template<typename T>
 void UIBinding<T>::set(T value)
 {
-    if (_locked)
+    // The widget is overwritten, so a change it has not propagated yet is obsolete.
+    _pending.reset();
+    Base::set(std::move(value));
+}
+
+template<typename T>
+void UIBinding<T>::setUpdatePolicy(UpdatePolicy policy, int msec)
+{
+    flush();
+    _timer.stop();
+    _policy = policy;
+    _timer.setInterval(msec);
+}
+
+template<typename T>
+void UIBinding<T>::flush()
+{
+    if (!_pending)
+        return;
+
+    std::unique_ptr<T> value(std::move(_pending));
+    this->onChange(*value);
+}
+
+template<typename T>
+void UIBinding<T>::widgetChanged(const T& value)
+{
+    switch (_policy)
+    {
+    case UpdatePolicy::Immediate:
+        this->onChange(value);
+        return;
+
+    case UpdatePolicy::Debounce:
+        hold(value);
+        _timer.start();
+        return;
+
+    case UpdatePolicy::Throttle:
+        if (_timer.isActive())
+        {
+            hold(value);
+            return;
+        }
+
+        // The leading change goes through at once, the rest wait for the interval to pass.
+        _timer.start();
+        this->onChange(value);
+        return;
+
+    case UpdatePolicy::OnCommit:
+        hold(value);
+        return;
+    }
+}
+
+template<typename T>
+void UIBinding<T>::timerFired()
+{
+    if (!_pending)
         return;
-    else
-        _locked = true;
 
-    Base::set(value);
+    // When throttling, the interval restarts with each propagated change.
+    if (_policy == UpdatePolicy::Throttle)
+        _timer.start();
 
-    _locked = false;
+    flush();
 }
 
 #endif // UIBINDING_H
@@ -5,26 +5,52 @@
 
 /*!
  * \brief A simple observable that just stores a single value.
+ *        The class is final, so the calls made through a ValueObservable reference
+ *        are resolved statically and may be inlined. set() works on the value directly,
+ *        so even through an Observable<T> reference it costs a single virtual call.
  */
 template<typename T>
-class ValueObservable : public Observable<T>
+class ValueObservable final : public Observable<T>
 {
 public:
-    ValueObservable(const T& value, bool firesOnAddCallback = true) :
-        Observable<T>(firesOnAddCallback), _value(value) {}
+    ValueObservable(T value, bool firesOnAddCallback = true) :
+        Observable<T>(firesOnAddCallback), _value(std::move(value)) {}
 
     virtual T get();
+
+    virtual void set(T value) { this->setStored(_value, std::move(value)); }
+
+    /*!< The stored value, without copying it. */
+    const T& value() const { return _value; }
+
+    /*!
+     * \brief Sets the value without notifying the callbacks,
+     *        e.g. to fill a model nobody observes yet. The version is incremented still.
+     *        Copying reuses the storage of the current value where the type allows, e.g. strings.
+     */
+    void assign(const T& value)
+    {
+        _value = value;
+        this->touch();
+    }
+
+    void assign(T&& value)
+    {
+        _value = std::move(value);
+        this->touch();
+    }
 protected:
-    virtual void doSet(T& newValue);
+    virtual void doSet(T&& newValue);
+    virtual const T *stored() { return &_value; }
 
 private:
     T _value;
 };
 
 template<typename T>
-void ValueObservable<T>::doSet(T& newValue)
+void ValueObservable<T>::doSet(T&& newValue)
 {
-    _value = newValue;
+    _value = std::move(newValue);
 }
 
 template<typename T>
@@ -1,9 +1,13 @@
 #ifndef VIEW_H
 #define VIEW_H
 
+#include <cmath>
 #include <memory>
-#include <QWidget>
+#include <QGuiApplication>
 #include <QResizeEvent>
+#include <QScreen>
+#include <QTimer>
+#include <QWidget>
 #include "size.h"
 #include "valueobservable.h"
 
@@ -18,6 +22,11 @@
  *  1) UI layout;
  *  2) data bindings;
  *  3) signal handling.
+ *
+ * The view's size is exposed as an observable, see sizeHandle().
+ * By default every resize event updates it. In the frame-aligned mode,
+ * e.g. for windows whose size is bound to a model, the resize events of
+ * an interactive drag are coalesced into at most one update per display frame.
  */
 template<typename VM, typename W>
 class View : public W
@@ -32,16 +41,37 @@ public:
     virtual void setViewModel(ViewModelPtr vm);
 
     Observable<Size>& sizeHandle() { return _size; }
+
+    /*!
+     * \brief Switches the frame-aligned mode of sizeHandle() on or off.
+     *        A resize is propagated at once, the ones following it within the frame interval
+     *        are coalesced into a single update of the latest size when the interval is over.
+     * \param msec - the frame interval, by default that of the primary screen's refresh rate.
+     *        Switching the mode propagates a pending size, if any.
+     */
+    void setFrameAligned(bool aligned, int msec = 0);
+
+    bool frameAligned() const { return _frameAligned; }
 protected:
     virtual void bind() = 0;
     virtual void unbind() = 0;
     virtual void resizeEvent(QResizeEvent *event);
 private:
+    /*!< Propagates the pending size, if any. */
+    void flushSize();
+
+    void frameTimerFired();
+
     ViewModelPtr _viewModel;
 
     using SizeStore = ValueObservable<Size>;
     SizeStore _size;
     SizeStore::CallbackPtr _sizeCallback;
+
+    bool _frameAligned;
+    bool _sizePending;
+    Size _pendingSize;
+    QTimer _frameTimer;
 };
 
 template<typename VM, typename W>
@@ -49,17 +79,83 @@ View<VM, W>::View(QWidget *parent,
      Qt::WindowFlags flags) :
     W(parent, flags),
     _viewModel(nullptr),
-    _size(Size(0, 0))
+    _size(Size(0, 0)),
+    _frameAligned(false),
+    _sizePending(false),
+    _pendingSize(0, 0)
 {
     _size.set(Size(this->size().width(), this->size().height()));
-    _sizeCallback = _size.addCallback([this](Size size) { this->resize(size.x, size.y); });
+
+    // The size the widget already has, e.g. reported by its own resize event, is not echoed back.
+    _sizeCallback = _size.addCallback([this](const Size& size)
+    {
+        if ((size.x != this->width()) || (size.y != this->height()))
+            this->resize(size.x, size.y);
+    }, NotificationPriority::Repaint);
+
+    _frameTimer.setSingleShot(true);
+    QObject::connect(&_frameTimer, &QTimer::timeout, [this]() { this->frameTimerFired(); });
 }
 
 template<typename VM, typename W>
 void View<VM, W>::resizeEvent(QResizeEvent *event)
 {
     W::resizeEvent(event);
-    _size.set(Size(event->size().width(), event->size().height()));
+
+    Size size(event->size().width(), event->size().height());
+    if (!_frameAligned)
+    {
+        _size.set(size);
+        return;
+    }
+
+    _pendingSize = size;
+    _sizePending = true;
+
+    // The leading resize goes through at once, the rest wait for the frame to end.
+    if (!_frameTimer.isActive())
+    {
+        flushSize();
+        _frameTimer.start();
+    }
+}
+
+template<typename VM, typename W>
+void View<VM, W>::setFrameAligned(bool aligned, int msec)
+{
+    flushSize();
+    _frameTimer.stop();
+    _frameAligned = aligned;
+
+    if (msec <= 0)
+    {
+        QScreen *screen = QGuiApplication::primaryScreen();
+        const qreal rate = screen ? screen->refreshRate() : 0;
+        msec = (rate > 0) ? int(std::lround(1000 / rate)) : 16;
+    }
+
+    _frameTimer.setInterval(msec);
+}
+
+template<typename VM, typename W>
+void View<VM, W>::flushSize()
+{
+    if (!_sizePending)
+        return;
+
+    _sizePending = false;
+    _size.set(_pendingSize);
+}
+
+template<typename VM, typename W>
+void View<VM, W>::frameTimerFired()
+{
+    if (!_sizePending)
+        return;
+
+    // The interval restarts with each propagated size, as long as the drag goes on.
+    _frameTimer.start();
+    flushSize();
 }
 
 template<typename VM, typename W>
@@ -8,7 +8,7 @@ int main(int argc, char *argv[])
     QApplication a(argc, argv);
     AppView appView;
 
-    MainViewModelPtr vm(std::make_shared<MainViewModel>());
+    MainViewModelPtr vm(MainViewModel::create());
     vm->initialize();
     appView.showMain(vm);
 
@@ -4,10 +4,11 @@
 #include <memory>
 
 MainView::MainView() :
-    _captionBinding(nullptr),
-    _inputBinding1(nullptr),
     _delegate(nullptr)
 {
+    // Dragging the window must not flood the view model with sizes.
+    setFrameAligned(true);
+
     _toolbar = new QToolBar();
     addToolBar(_toolbar);
 
@@ -22,21 +23,9 @@ MainView::MainView() :
 
     _input1 = new QLineEdit(central);
     layout->addWidget(_input1);
-    _inputBinding1 = std::make_shared<InputBinding>(
-            [this]() { return _input1->text(); },
-            [this](QString text) { _input1->setText(text); },
-            _input1,
-            &QLineEdit::textChanged
-    );
 
     _input2 = new QLineEdit(central);
     layout->addWidget(_input2);
-    _inputBinding2 = std::make_shared<InputBinding>(
-            [this]() { return _input2->text(); },
-            [this](QString text) { _input2->setText(text); },
-            _input2,
-            &QLineEdit::textChanged
-    );
 
     _moreBtn = new QPushButton(central);
     layout->addWidget(_moreBtn);
@@ -59,44 +48,19 @@ void MainView::bind()
     if (!vm)
         return;
 
-    _captionBinding = vm->caption().addCallback(
-                [this] (std::string newV) {
-                    QString newText = QString::fromStdString(newV);
-                    this->_captionLabel->setText(newText);
-                });
-
-    _moreTitleBinding = vm->more().addCallback(
-                [this] (std::string newV) {
-                    QString newText = QString::fromStdString(newV);
-                    this->_moreBtn->setText(newText);
-                });
-
-    auto strToQ = [](const std::string& str)
-    {
-        return QString::fromStdString(str);
-    };
-
-    auto qToStr = [](const QString& qstr)
-    {
-        return qstr.toStdString();
-    };
-
-    _inputBinding1->bindTwoWay(vm->text(), strToQ, qToStr);
-    _inputBinding2->bindTwoWay(vm->text(), strToQ, qToStr);
+    _captionBinding.bind(vm->caption(), _captionLabel);
+    _moreTitleBinding.bind(vm->more(), _moreBtn);
+    _inputBinding1.bind(vm->text(), _input1, _input1, &QLineEdit::textChanged);
+    _inputBinding2.bind(vm->text(), _input2, _input2, &QLineEdit::textChanged);
     sizeHandle().bindTwoWay(vm->size());
 }
 
 void MainView::unbind()
 {
-    _captionBinding = nullptr;
-    _moreTitleBinding = nullptr;
-
-    MainViewModelPtr vm = viewModel();
-    if (vm)
-        vm->text().unbind();
-
-    _inputBinding1->unbind();
-    _inputBinding2->unbind();
+    _captionBinding.unbind();
+    _moreTitleBinding.unbind();
+    _inputBinding1.unbind();
+    _inputBinding2.unbind();
 }
 
 MainView::Delegate *MainView::delegate() const
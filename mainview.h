@@ -9,7 +9,8 @@
 #include <QLineEdit>
 #include <QMainWindow>
 #include <QPushButton>
-#include "lib/uibinding.h"
+#include <string>
+#include "lib/staticbinding.h"
 
 class MainView : public View<MainViewModel, QMainWindow>
 {
@@ -31,24 +32,37 @@ protected:
     void bind();
     void unbind();
 private:
-    using Text = MainViewModel::Text;
-    using TextBinding = Text::CallbackPtr;
-    using InputBinding = UIBinding<QString>;
-    using IBPtr = std::shared_ptr<InputBinding>;
+    struct StdToQString
+    {
+        QString operator()(const std::string& str) const { return QString::fromStdString(str); }
+    };
+
+    struct QStringToStd
+    {
+        std::string operator()(const QString& qstr) const { return qstr.toStdString(); }
+    };
+
+    using LabelText = Property<QLabel, QString, &QLabel::text, &QLabel::setText>;
+    using ButtonText = Property<QAbstractButton, QString, &QAbstractButton::text, &QAbstractButton::setText>;
+    using EditText = Property<QLineEdit, QString, &QLineEdit::text, &QLineEdit::setText>;
+
+    using LabelBinding = StaticBinding<std::string, LabelText, StdToQString>;
+    using ButtonBinding = StaticBinding<std::string, ButtonText, StdToQString>;
+    using InputBinding = StaticBinding<std::string, EditText, StdToQString, QStringToStd>;
 
     QLabel *_captionLabel;
-    TextBinding _captionBinding;
+    LabelBinding _captionBinding;
 
     QToolBar *_toolbar;
 
     QLineEdit *_input1;
-    IBPtr _inputBinding1;
+    InputBinding _inputBinding1;
 
     QLineEdit *_input2;
-    IBPtr _inputBinding2;
+    InputBinding _inputBinding2;
 
     QPushButton *_moreBtn;
-    TextBinding _moreTitleBinding;
+    ButtonBinding _moreTitleBinding;
     QMetaObject::Connection _moreConnection;
 
     Delegate *_delegate;
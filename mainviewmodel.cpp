@@ -1,4 +1,6 @@
 #include "mainviewmodel.h"
+#include <utility>
+#include "lib/observablearena.h"
 
 MainViewModel::MainViewModel() :
     _initialized(false),
@@ -7,6 +9,33 @@ MainViewModel::MainViewModel() :
     _more(""),
     _size(Size(0, 0))
 {
+    _text.setName("MainViewModel.text");
+    _caption.setName("MainViewModel.caption");
+    _more.setName("MainViewModel.more");
+    _size.setName("MainViewModel.size");
+
+    _fields.add(_text);
+    _fields.add(_caption);
+    _fields.add(_more);
+    _fields.add(_size);
+}
+
+MainViewModelPtr MainViewModel::create()
+{
+    ObservableArena::Ref arena = ObservableArena::create();
+    ObservableArena::Scope scope(arena.get());
+    return std::allocate_shared<MainViewModel>(ArenaAllocator<MainViewModel>(arena.get()));
+}
+
+MainViewModelPtr MainViewModel::load(const void *data, std::size_t size)
+{
+    // Nobody observes the new model yet, so the values are assigned without notifications.
+    MainViewModelPtr model = create();
+    if (!model->_fields.load(data, size, false))
+        return MainViewModelPtr();
+
+    model->_initialized = true;
+    return model;
 }
 
 void MainViewModel::initialize()
@@ -14,14 +43,16 @@ void MainViewModel::initialize()
     if (_initialized)
         return;
 
+    ObservableBatch batch;
+
     std::string info("This is an observable Qt example.");
-    _caption.set(info);
+    _caption.set(std::move(info));
 
     std::string text("The values are synchronized.");
-    _text.set(text);
+    _text.set(std::move(text));
 
     std::string more("More...");
-    _more.set(more);
+    _more.set(std::move(more));
 
     _size.set(Size(400, 150));
 
@@ -30,13 +61,9 @@ void MainViewModel::initialize()
 
 MainViewModelPtr MainViewModel::clone()
 {
-    MainViewModelPtr copy =
-            std::make_shared<MainViewModel>();
-
-    copy->text().set(text().get());
-    copy->caption().set(caption().get());
-    copy->more().set(more().get());
-    copy->size().set(size().get());
+    // Nobody observes the new model yet, so the values are copied without notifications.
+    MainViewModelPtr copy = create();
+    _fields.copyTo(copy->_fields);
 
     return copy;
 }
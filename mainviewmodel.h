@@ -1,8 +1,10 @@
 #ifndef MAINVIEWMODEL_H
 #define MAINVIEWMODEL_H
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include "lib/observablefields.h"
 #include "lib/valueobservable.h"
 #include "lib/size.h"
 
@@ -14,6 +16,13 @@ class MainViewModel
 {
 public:
     MainViewModel();
+
+    /*!< Creates a model that keeps itself and its subscriptions in an arena of its own. */
+    static MainViewModelPtr create();
+
+    /*!< Creates a model from an image written by fields().save(), or returns nullptr if it is malformed. */
+    static MainViewModelPtr load(const void *data, std::size_t size);
+
     void initialize();
 
     using Text = Observable<std::string>;
@@ -23,6 +32,9 @@ public:
     Text& more() { return _more; }
     Observable<Size>& size() { return _size; }
 
+    /*!< All the fields, e.g. to take undo snapshots. */
+    ObservableFields& fields() { return _fields; }
+
     MainViewModelPtr clone();
 private:
     bool _initialized;
@@ -34,6 +46,8 @@ private:
 
     using SizeStore = ValueObservable<Size>;
     SizeStore _size;
+
+    ObservableFields _fields;
 };
 
 #endif // MAINVIEWMODEL_H
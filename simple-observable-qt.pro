@@ -24,6 +24,10 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 CONFIG += c++11
 
+# Per-observable counters and callback latency histograms, see lib/instrumentation.h.
+# Build with "qmake CONFIG+=instrumented" to enable them.
+instrumented: DEFINES += OBSERVABLE_INSTRUMENTATION
+
 SOURCES += \
         appview.cpp \
         main.cpp \
@@ -33,8 +37,32 @@ SOURCES += \
 HEADERS += \
         appview.h \
         lib/aliasobservable.h \
+        lib/asyncobservable.h \
+        lib/atomicsnapshot.h \
+        lib/binarycodec.h \
+        lib/changestream.h \
+        lib/computedobservable.h \
+        lib/concurrentobservable.h \
+        lib/flathashmap.h \
+        lib/inlinefunction.h \
+        lib/instrumentation.h \
+        lib/notificationscheduler.h \
         lib/observable.h \
+        lib/observablearena.h \
+        lib/observablebatch.h \
+        lib/observablefields.h \
+        lib/observablelistmodel.h \
+        lib/observablemap.h \
+        lib/observablevector.h \
+        lib/propagation.h \
+        lib/queueddelivery.h \
+        lib/sharedvalueobservable.h \
         lib/size.h \
+        lib/slotmap.h \
+        lib/staticbinding.h \
+        lib/subscription.h \
+        lib/syncgroup.h \
+        lib/threadpool.h \
         lib/uibinding.h \
         lib/valueobservable.h \
         lib/view.h \